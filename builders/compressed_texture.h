@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+/*
+ *  Parses pre-compressed texture containers (KTX2 and DDS) holding BC1/BC3/BC4/BC5/BC7 blocks.
+ *
+ *  The block data is left untouched so it can be copied straight into a staging buffer; no decoding happens on the CPU.
+ */
+
+namespace fr {
+    struct CompressedMipLevel {
+        std::size_t   offset;  // Byte offset of the level within CompressedImage::data
+        std::size_t   size;
+        std::uint32_t width;
+        std::uint32_t height;
+    };
+
+    struct CompressedImage {
+        VkFormat      format = VK_FORMAT_UNDEFINED;
+        std::uint32_t width  = 0;
+        std::uint32_t height = 0;
+        std::vector<CompressedMipLevel> mip_levels;  // Largest level first
+        std::vector<char> data;                      // The raw container file
+
+        [[nodiscard]] std::size_t payload_size() const;
+    };
+
+    namespace compressed_texture {
+        /// True if the path has a container extension that should bypass the stb decoder (.ktx2 / .dds)
+        bool is_container(const std::filesystem::path& path);
+
+        CompressedImage load(const std::filesystem::path& path);
+
+        CompressedImage parse_ktx2(std::vector<char> data);
+
+        CompressedImage parse_dds(std::vector<char> data);
+
+        /// Size in bytes of a 4x4 block for the supported BC formats
+        std::uint32_t block_size(VkFormat format);
+
+        /// Size in bytes of one mip level of a block compressed image
+        std::size_t level_size(VkFormat format, std::uint32_t width, std::uint32_t height);
+    }  // namespace compressed_texture
+}  // namespace fr
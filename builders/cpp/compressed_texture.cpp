@@ -0,0 +1,276 @@
+#include "compressed_texture.h"
+#include "utils/file_system.h"
+#include "utils/image_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace fr {
+    namespace {
+        template<typename T>
+        T read_value(const std::vector<char>& data, const std::size_t offset) {
+            if (offset + sizeof(T) > data.size()) {
+                throw std::runtime_error("Compressed texture header is truncated.");
+            }
+
+            T value;
+            std::memcpy(&value, data.data() + offset, sizeof(T));
+            return value;
+        }
+
+        constexpr std::uint32_t four_cc(const char a, const char b, const char c, const char d) {
+            return static_cast<std::uint32_t>(a)
+                | (static_cast<std::uint32_t>(b) << 8)
+                | (static_cast<std::uint32_t>(c) << 16)
+                | (static_cast<std::uint32_t>(d) << 24);
+        }
+
+        constexpr std::array<std::uint8_t, 12> ktx2_identifier = {
+            0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+        };
+
+        // DDS layout: "DDS " magic, 124 byte DDS_HEADER, optional 20 byte DDS_HEADER_DXT10
+        constexpr std::size_t dds_header_offset      = 4;
+        constexpr std::size_t dds_header_size        = 124;
+        constexpr std::size_t dds_dx10_header_size   = 20;
+        constexpr std::uint32_t dds_pixel_format_fourcc = 0x4;
+        constexpr std::uint32_t dds_caps2_cubemap       = 0x200;
+        constexpr std::uint32_t dds_caps2_volume        = 0x200000;
+        constexpr std::uint32_t dx10_dimension_texture2d = 3;
+        constexpr std::uint32_t dx10_misc_texture_cube   = 0x4;
+
+        VkFormat format_from_dxgi(const std::uint32_t dxgi_format) {
+            switch (dxgi_format) {
+                case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+                case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+                case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+                case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+                case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+                case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+                case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+                case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+                case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+                case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+                default: throw std::runtime_error("Unsupported DXGI format in DDS texture.");
+            }
+        }
+
+        VkFormat format_from_four_cc(const std::uint32_t code) {
+            // Legacy DDS files carry no colour space; DXT1/DXT5 are treated as sRGB colour maps like the stb path
+            if (code == four_cc('D', 'X', 'T', '1')) return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            if (code == four_cc('D', 'X', 'T', '5')) return VK_FORMAT_BC3_SRGB_BLOCK;
+            if (code == four_cc('A', 'T', 'I', '1') || code == four_cc('B', 'C', '4', 'U')) return VK_FORMAT_BC4_UNORM_BLOCK;
+            if (code == four_cc('A', 'T', 'I', '2') || code == four_cc('B', 'C', '5', 'U')) return VK_FORMAT_BC5_UNORM_BLOCK;
+
+            throw std::runtime_error("Unsupported FourCC in DDS texture.");
+        }
+
+        /// Read before the level loops, so a corrupt header cannot drive them past a full chain
+        void validate_extent(const std::uint32_t width, const std::uint32_t height, const std::uint32_t level_count) {
+            if (width == 0 || height == 0) {
+                throw std::runtime_error("Compressed texture has a zero width or height.");
+            }
+
+            if (level_count > image::calculate_mip_levels(width, height)) {
+                throw std::runtime_error("Compressed texture has more mip levels than its dimensions allow.");
+            }
+        }
+
+        void validate_levels(const CompressedImage& image) {
+            for (const auto& level : image.mip_levels) {
+                if (level.offset > image.data.size() || level.size > image.data.size() - level.offset) {
+                    throw std::runtime_error("Compressed texture mip level lies outside of the file.");
+                }
+
+                // The copy to the image reads a full level, whatever size the container claims
+                if (level.size != compressed_texture::level_size(image.format, level.width, level.height)) {
+                    throw std::runtime_error("Compressed texture mip level does not match the size of its dimensions.");
+                }
+            }
+        }
+    }  // namespace
+
+    std::size_t CompressedImage::payload_size() const {
+        std::size_t size = 0;
+        for (const auto& level : mip_levels) {
+            size += level.size;
+        }
+
+        return size;
+    }
+
+    namespace compressed_texture {
+        bool is_container(const std::filesystem::path& path) {
+            auto extension = path.extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), [](const unsigned char c) { return std::tolower(c); });
+
+            return extension == ".ktx2" || extension == ".dds";
+        }
+
+        CompressedImage load(const std::filesystem::path& path) {
+            auto data = file_system::read_binary_file(path);
+
+            if (data.size() >= ktx2_identifier.size() && std::memcmp(data.data(), ktx2_identifier.data(), ktx2_identifier.size()) == 0) {
+                return parse_ktx2(std::move(data));
+            }
+
+            if (data.size() >= 4 && read_value<std::uint32_t>(data, 0) == four_cc('D', 'D', 'S', ' ')) {
+                return parse_dds(std::move(data));
+            }
+
+            throw std::runtime_error("Texture is neither a KTX2 nor a DDS container.");
+        }
+
+        CompressedImage parse_ktx2(std::vector<char> data) {
+            // Header fields directly follow the 12 byte identifier
+            constexpr std::size_t header = 12;
+
+            CompressedImage image {};
+            image.format  = static_cast<VkFormat>(read_value<std::uint32_t>(data, header + 0));
+            image.width   = read_value<std::uint32_t>(data, header + 8);
+            image.height  = read_value<std::uint32_t>(data, header + 12);
+
+            const auto depth           = read_value<std::uint32_t>(data, header + 16);
+            const auto layer_count     = read_value<std::uint32_t>(data, header + 20);
+            const auto face_count      = read_value<std::uint32_t>(data, header + 24);
+            const auto level_count     = std::max(read_value<std::uint32_t>(data, header + 28), 1u);
+            const auto supercompression = read_value<std::uint32_t>(data, header + 32);
+
+            if (depth > 1 || layer_count > 1 || face_count != 1) {
+                throw std::runtime_error("Only 2D KTX2 textures are supported.");
+            }
+
+            if (supercompression != 0) {
+                throw std::runtime_error("Supercompressed KTX2 textures (BasisLZ / Zstandard) are not supported.");
+            }
+
+            block_size(image.format);  // throws for non BC formats
+            validate_extent(image.width, image.height, level_count);
+
+            // Level index follows the 80 byte header + index section: {byteOffset, byteLength, uncompressedByteLength}
+            constexpr std::size_t level_index = 80;
+            std::uint32_t width  = image.width;
+            std::uint32_t height = image.height;
+            for (std::uint32_t level = 0; level < level_count; ++level) {
+                const std::size_t entry = level_index + level * 3 * sizeof(std::uint64_t);
+
+                image.mip_levels.push_back(CompressedMipLevel {
+                    .offset = static_cast<std::size_t>(read_value<std::uint64_t>(data, entry)),
+                    .size   = static_cast<std::size_t>(read_value<std::uint64_t>(data, entry + sizeof(std::uint64_t))),
+                    .width  = width,
+                    .height = height
+                });
+
+                width  = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+
+            image.data = std::move(data);
+            validate_levels(image);
+
+            return image;
+        }
+
+        CompressedImage parse_dds(std::vector<char> data) {
+            constexpr std::size_t header = dds_header_offset;
+
+            if (read_value<std::uint32_t>(data, header) != dds_header_size) {
+                throw std::runtime_error("DDS header has an invalid size.");
+            }
+
+            CompressedImage image {};
+            image.height = read_value<std::uint32_t>(data, header + 8);
+            image.width  = read_value<std::uint32_t>(data, header + 12);
+            const auto level_count = std::max(read_value<std::uint32_t>(data, header + 24), 1u);
+
+            const auto caps2 = read_value<std::uint32_t>(data, header + 108);
+            if (caps2 & (dds_caps2_cubemap | dds_caps2_volume)) {
+                throw std::runtime_error("Only 2D DDS textures are supported.");
+            }
+
+            // DDS_PIXELFORMAT starts 72 bytes into the header: {size, flags, fourCC, ...}
+            const auto pixel_format_flags = read_value<std::uint32_t>(data, header + 76);
+            const auto pixel_format_code  = read_value<std::uint32_t>(data, header + 80);
+
+            if (!(pixel_format_flags & dds_pixel_format_fourcc)) {
+                throw std::runtime_error("Uncompressed DDS textures are not supported.");
+            }
+
+            validate_extent(image.width, image.height, level_count);
+
+            std::size_t offset = header + dds_header_size;
+            if (pixel_format_code == four_cc('D', 'X', '1', '0')) {
+                image.format = format_from_dxgi(read_value<std::uint32_t>(data, offset));
+
+                const auto dimension  = read_value<std::uint32_t>(data, offset + 4);
+                const auto misc_flags = read_value<std::uint32_t>(data, offset + 8);
+                if (dimension != dx10_dimension_texture2d || (misc_flags & dx10_misc_texture_cube)) {
+                    throw std::runtime_error("Only 2D DDS textures are supported.");
+                }
+
+                const auto array_size = read_value<std::uint32_t>(data, offset + 12);
+                if (array_size > 1) {
+                    throw std::runtime_error("DDS texture arrays are not supported.");
+                }
+
+                offset += dds_dx10_header_size;
+            } else {
+                image.format = format_from_four_cc(pixel_format_code);
+            }
+
+            // DDS stores levels back to back, largest first
+            std::uint32_t width  = image.width;
+            std::uint32_t height = image.height;
+            for (std::uint32_t level = 0; level < level_count; ++level) {
+                const std::size_t size = level_size(image.format, width, height);
+
+                image.mip_levels.push_back(CompressedMipLevel {
+                    .offset = offset,
+                    .size   = size,
+                    .width  = width,
+                    .height = height
+                });
+
+                offset += size;
+                width  = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+
+            image.data = std::move(data);
+            validate_levels(image);
+
+            return image;
+        }
+
+        std::uint32_t block_size(const VkFormat format) {
+            switch (format) {
+                case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+                case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                case VK_FORMAT_BC4_UNORM_BLOCK:
+                case VK_FORMAT_BC4_SNORM_BLOCK:
+                    return 8;
+                case VK_FORMAT_BC3_UNORM_BLOCK:
+                case VK_FORMAT_BC3_SRGB_BLOCK:
+                case VK_FORMAT_BC5_UNORM_BLOCK:
+                case VK_FORMAT_BC5_SNORM_BLOCK:
+                case VK_FORMAT_BC7_UNORM_BLOCK:
+                case VK_FORMAT_BC7_SRGB_BLOCK:
+                    return 16;
+                default:
+                    throw std::runtime_error("Unsupported block compressed texture format.");
+            }
+        }
+
+        std::size_t level_size(const VkFormat format, const std::uint32_t width, const std::uint32_t height) {
+            const std::size_t blocks_x = std::max((width + 3) / 4, 1u);
+            const std::size_t blocks_y = std::max((height + 3) / 4, 1u);
+
+            return blocks_x * blocks_y * block_size(format);
+        }
+    }  // namespace compressed_texture
+}  // namespace fr
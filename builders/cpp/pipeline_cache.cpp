@@ -0,0 +1,142 @@
+#include "pipeline_cache.h"
+#include "utils/error.h"
+#include "utils/file_system.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace fr {
+    PipelineCache::PipelineCache(VkDevice device, VkPhysicalDevice gpu, std::filesystem::path path)
+        : _device(device)
+        , _path(std::move(path))
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(gpu, &properties);
+
+        _expected_header.vendor_id      = properties.vendorID;
+        _expected_header.device_id      = properties.deviceID;
+        _expected_header.driver_version = properties.driverVersion;
+        std::memcpy(_expected_header.cache_uuid.data(), properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        const std::vector<char> data = _read_valid_data();
+        _loaded = !data.empty();
+
+        VkPipelineCacheCreateInfo cache_info {
+            .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = data.size(),
+            .pInitialData    = data.empty() ? nullptr : data.data()
+        };
+
+        // A driver may still reject data that passed our checks, in which case start from an empty cache
+        if (vkCreatePipelineCache(_device, &cache_info, nullptr, &_cache) != VK_SUCCESS) {
+            cache_info.initialDataSize = 0;
+            cache_info.pInitialData    = nullptr;
+            _loaded = false;
+
+            validate(
+                vkCreatePipelineCache(_device, &cache_info, nullptr, &_cache),
+                "Failed to create pipeline cache."
+            );
+        }
+    }
+
+    PipelineCache::~PipelineCache() {
+        try {
+            save();
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to save the pipeline cache: " << e.what() << "\n";
+        }
+
+        vkDestroyPipelineCache(_device, _cache, nullptr);
+    }
+
+    void PipelineCache::save() const {
+        std::size_t data_size = 0;
+        validate(
+            vkGetPipelineCacheData(_device, _cache, &data_size, nullptr),
+            "Failed to query pipeline cache size."
+        );
+
+        std::vector<char> data(data_size);
+        validate(
+            vkGetPipelineCacheData(_device, _cache, &data_size, data.data()),
+            "Failed to read pipeline cache data."
+        );
+        data.resize(data_size);
+
+        PipelineCacheFileHeader header = _expected_header;
+        header.data_size = data.size();
+        header.data_hash = file_system::hash_bytes(data.data(), data.size());
+
+        std::filesystem::create_directories(_path.parent_path());
+
+        // Several processes may share the cache; each writes its own temporary file and renames it into place
+        file_system::write_file_atomically(_path, {
+            std::as_bytes(std::span(&header, 1)),
+            std::as_bytes(std::span(data))
+        });
+    }
+
+    bool PipelineCache::was_loaded() const {
+        return _loaded;
+    }
+
+    std::filesystem::path PipelineCache::default_path() {
+        std::filesystem::path directory;
+        if (const char* cache_home = std::getenv("XDG_CACHE_HOME"); cache_home != nullptr && *cache_home != '\0') {
+            directory = cache_home;
+        } else if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+            directory = std::filesystem::path(home) / ".cache";
+        } else {
+            directory = std::filesystem::temp_directory_path();
+        }
+
+        return directory / "four_rendering" / "pipeline_cache.bin";
+    }
+
+    std::vector<char> PipelineCache::_read_valid_data() const {
+        std::ifstream file(_path, std::ios::binary);
+        if (!file.is_open()) {
+            return {};
+        }
+
+        PipelineCacheFileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            return {};
+        }
+
+        const bool matches_device =
+            header.magic          == PipelineCacheFileHeader::expected_magic &&
+            header.version        == PipelineCacheFileHeader::current_version &&
+            header.vendor_id      == _expected_header.vendor_id &&
+            header.device_id      == _expected_header.device_id &&
+            header.driver_version == _expected_header.driver_version &&
+            header.cache_uuid     == _expected_header.cache_uuid;
+        if (!matches_device) {
+            return {};
+        }
+
+        // Guards against a corrupt size before allocating
+        std::error_code error;
+        const auto file_size = std::filesystem::file_size(_path, error);
+        if (error || header.data_size > file_size - sizeof(header)) {
+            return {};
+        }
+
+        std::vector<char> data(header.data_size);
+        if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+            return {};
+        }
+
+        if (file_system::hash_bytes(data.data(), data.size()) != header.data_hash) {
+            return {};
+        }
+
+        return data;
+    }
+}  // namespace fr
@@ -0,0 +1,115 @@
+#include "sampler_cache.h"
+#include "utils/error.h"
+#include "utils/file_system.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace fr {
+    SamplerSettings SamplerSettings::clamped(const float max_anisotropy) {
+        return SamplerSettings {
+            .address_u      = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .address_v      = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .address_w      = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .max_anisotropy = max_anisotropy
+        };
+    }
+
+    std::size_t SamplerSettingsHash::operator()(const SamplerSettings& settings) const {
+        // Hashed field by field, the struct has padding
+        std::uint64_t hash = file_system::hash_bytes(&settings.mag_filter, sizeof(settings.mag_filter));
+        const auto combine = [&hash](const auto& value) {
+            hash = file_system::hash_bytes(&value, sizeof(value), hash);
+        };
+        // -0.0f == 0.0f, so both must hash alike
+        const auto combine_float = [&combine](const float value) {
+            combine(value == 0.0f ? 0.0f : value);
+        };
+
+        combine(settings.min_filter);
+        combine(settings.mipmap_mode);
+        combine(settings.address_u);
+        combine(settings.address_v);
+        combine(settings.address_w);
+        combine(settings.border_color);
+        combine_float(settings.mip_lod_bias);
+        combine_float(settings.max_anisotropy);
+        combine(settings.compare_enable);
+        combine(settings.compare_op);
+        combine_float(settings.min_lod);
+        combine_float(settings.max_lod);
+
+        return static_cast<std::size_t>(hash);
+    }
+
+    SamplerCache::SamplerCache(VkDevice device, const float max_anisotropy, const std::uint32_t max_samplers)
+        : _device(device)
+        , _max_anisotropy(max_anisotropy)
+        , _max_samplers(max_samplers)
+    { }
+
+    SamplerCache::~SamplerCache() {
+        for (const auto& [settings, sampler] : _samplers) {
+            vkDestroySampler(_device, sampler, nullptr);
+        }
+    }
+
+    VkSampler SamplerCache::get(const SamplerSettings& requested) {
+        // The key holds the anisotropy the sampler is created with, so requests above the device limit share one sampler
+        SamplerSettings settings = requested;
+        settings.max_anisotropy = std::min(settings.max_anisotropy, _max_anisotropy);
+        if (settings.max_anisotropy <= 1.0f) {
+            settings.max_anisotropy = 0.0f;
+        }
+
+        std::lock_guard lock(_mutex);
+
+        if (const auto it = _samplers.find(settings); it != _samplers.end()) {
+            return it->second;
+        }
+
+        if (_samplers.size() >= _max_samplers) {
+            throw std::runtime_error("Sampler cache reached the device's maxSamplerAllocationCount.");
+        }
+
+        VkSampler sampler = _create_sampler(settings);
+        _samplers.emplace(settings, sampler);
+
+        return sampler;
+    }
+
+    std::size_t SamplerCache::size() const {
+        std::lock_guard lock(_mutex);
+        return _samplers.size();
+    }
+
+    VkSampler SamplerCache::_create_sampler(const SamplerSettings& settings) const {
+        // Already clamped to the device limit by get()
+        const float anisotropy = settings.max_anisotropy;
+
+        VkSamplerCreateInfo sampler_info {};
+        sampler_info.sType            = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter        = settings.mag_filter;
+        sampler_info.minFilter        = settings.min_filter;
+        sampler_info.mipmapMode       = settings.mipmap_mode;
+        sampler_info.addressModeU     = settings.address_u;
+        sampler_info.addressModeV     = settings.address_v;
+        sampler_info.addressModeW     = settings.address_w;
+        sampler_info.mipLodBias       = settings.mip_lod_bias;
+        sampler_info.anisotropyEnable = anisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+        sampler_info.maxAnisotropy    = std::max(anisotropy, 1.0f);
+        sampler_info.compareEnable    = settings.compare_enable ? VK_TRUE : VK_FALSE;
+        sampler_info.compareOp        = settings.compare_op;
+        sampler_info.minLod           = settings.min_lod;
+        sampler_info.maxLod           = settings.max_lod;
+        sampler_info.borderColor      = settings.border_color;
+
+        VkSampler sampler;
+        validate(
+            vkCreateSampler(_device, &sampler_info, nullptr, &sampler),
+            "Failed to create texture sampler."
+        );
+
+        return sampler;
+    }
+}  // namespace fr
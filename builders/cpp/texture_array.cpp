@@ -0,0 +1,282 @@
+#include "texture_array.h"
+#include "utils/buffer_utils.h"
+#include "utils/error.h"
+#include "utils/scoped_command_buffer.h"
+#include "utils/image_utils.h"
+
+#include "stb/stb_image.h"
+
+#include <algorithm>
+#include <memory>
+#include <span>
+
+namespace fr {
+    TextureArray::TextureArray(const std::shared_ptr<VkContext>& context, const std::uint32_t width, const std::uint32_t height, const std::uint32_t layer_count)
+        : _context(context)
+        , _width(width)
+        , _height(height)
+        , _layer_count(layer_count)
+        , _allocated(layer_count, false)
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(_context->gpu, &properties);
+
+        if (layer_count == 0 || layer_count > properties.limits.maxImageArrayLayers) {
+            throw std::runtime_error("Texture array layer count is not supported by the physical device.");
+        }
+
+        _mip_levels   = image::calculate_mip_levels(width, height);
+        _blit_mipmaps = image::supports_linear_blit(_context->gpu, _format);
+
+        // Hand out the lowest layers first
+        _free_layers.reserve(layer_count);
+        for (std::uint32_t layer = layer_count; layer > 0; --layer) {
+            _free_layers.push_back(layer - 1);
+        }
+
+        _create_image();
+        _create_view();
+        _create_sampler();
+        _initialize_layers();
+    }
+
+    TextureArray::~TextureArray() {
+        vkDeviceWaitIdle(_context->device);
+
+        vkDestroyImageView(_context->device, _info.view, nullptr);
+        vmaDestroyImage(_context->allocator, _info.image, _allocation);
+    }
+
+    std::uint32_t TextureArray::allocate_layer() {
+        if (_free_layers.empty()) {
+            throw std::runtime_error("Texture array has no free layers.");
+        }
+
+        const std::uint32_t layer = _free_layers.back();
+        _free_layers.pop_back();
+        _allocated[layer] = true;
+
+        return layer;
+    }
+
+    void TextureArray::release_layer(const std::uint32_t layer) {
+        _validate_layer(layer);
+
+        _allocated[layer] = false;
+        _free_layers.push_back(layer);
+    }
+
+    void TextureArray::upload_layer(const std::uint32_t layer, const std::filesystem::path& path) {
+        if (!exists(path)) {
+            throw std::runtime_error("Texture image path was not found.");
+        }
+
+        int width, height, channels;
+        const std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> data(
+            stbi_load(path.c_str(), &width, &height, &channels, 0),
+            stbi_image_free
+        );
+        if (data == nullptr) {
+            throw std::runtime_error("Failed to decode texture image.");
+        }
+
+        if (static_cast<std::uint32_t>(width) != _width || static_cast<std::uint32_t>(height) != _height) {
+            throw std::runtime_error("Texture image size does not match the texture array.");
+        }
+
+        if (channels == 4) {
+            upload_layer(layer, data.get());
+            return;
+        }
+
+        std::vector<std::uint8_t> rgba(static_cast<std::size_t>(width) * height * 4);
+        image::expand_to_rgba8(data.get(), channels, static_cast<std::size_t>(width) * height, rgba.data());
+        upload_layer(layer, rgba.data());
+    }
+
+    void TextureArray::upload_layer(const std::uint32_t layer, const std::uint8_t* data) {
+        _validate_layer(layer);
+
+        // Only the base level is staged when the GPU builds the mips, otherwise the CPU filtered chain follows it
+        const std::size_t base_size = static_cast<std::size_t>(_width) * _height * 4;
+        std::vector<std::uint8_t> chain;
+        std::vector<std::span<const std::uint8_t>> levels = {std::span(data, base_size)};
+        if (!_blit_mipmaps) {
+            levels = image::generate_mip_chain_rgba8(data, _width, _height, _mip_levels, _format, chain);
+        }
+
+        auto buffer_utils = BufferUtils(_context);
+        auto staging_buffer = BufferCore(&_context->device, &_context->allocator);
+        buffer_utils.create_staging_buffer(staging_buffer, base_size + chain.size());
+
+        std::vector<VkBufferImageCopy> regions;
+        VkDeviceSize offset = 0;
+        std::uint32_t width = _width;
+        std::uint32_t height = _height;
+        for (std::uint32_t mip = 0; mip < levels.size(); ++mip) {
+            validate(
+                vmaCopyMemoryToAllocation(_context->allocator, levels[mip].data(), staging_buffer.allocation, offset, levels[mip].size()),
+                "Failed to copy texture layer to the staging buffer."
+            );
+
+            VkBufferImageCopy region {};
+            region.bufferOffset = offset;
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip, layer, 1};
+            region.imageExtent = {width, height, 1};
+            regions.push_back(region);
+
+            offset += levels[mip].size();
+            width  = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+
+        {
+            auto cmd = ScopedCommandBuffer(_context);
+            cmd.begin();
+
+            // Earlier frames may still sample the layer; the old contents are discarded
+            image::transition_layout(
+                cmd.get_command_buffer(),
+                _info.image,
+                VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                0,
+                _mip_levels,
+                layer
+            );
+
+            vkCmdCopyBufferToImage(
+                cmd.get_command_buffer(),
+                staging_buffer.buffer,
+                _info.image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<std::uint32_t>(regions.size()),
+                regions.data()
+            );
+
+            if (_blit_mipmaps) {
+                image::generate_mipmaps(cmd.get_command_buffer(), _info.image, _width, _height, _mip_levels, layer);
+            } else {
+                image::transition_layout(
+                    cmd.get_command_buffer(),
+                    _info.image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    VK_ACCESS_2_SHADER_READ_BIT,
+                    VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                    0,
+                    _mip_levels,
+                    layer
+                );
+            }
+        }
+    }
+
+    TextureInfo TextureArray::get_info() {
+        _info.image_info = {
+            .sampler     = _info.sampler,
+            .imageView   = _info.view,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        };
+        return _info;
+    }
+
+    std::uint32_t TextureArray::get_layer_count() const {
+        return _layer_count;
+    }
+
+    std::uint32_t TextureArray::get_free_layer_count() const {
+        return static_cast<std::uint32_t>(_free_layers.size());
+    }
+
+    void TextureArray::_create_image() {
+        VkImageCreateInfo image_info {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = _format,
+            .extent = {
+                .width = _width,
+                .height = _height,
+                .depth = 1
+            },
+            .mipLevels = _mip_levels,
+            .arrayLayers = _layer_count,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        VmaAllocationCreateInfo alloc_create_info {
+            .usage = VMA_MEMORY_USAGE_GPU_ONLY
+        };
+
+        VmaAllocationInfo alloc_info;
+        validate(
+            vmaCreateImage(_context->allocator, &image_info, &alloc_create_info, &_info.image, &_allocation, &alloc_info),
+            "Failed to create texture array image."
+        );
+
+        _info.size = alloc_info.size;
+    }
+
+    void TextureArray::_create_view() {
+        VkImageViewCreateInfo view_info {};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = _info.image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+        view_info.format = _format;
+        view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        view_info.subresourceRange.baseMipLevel = 0;
+        view_info.subresourceRange.levelCount = _mip_levels;
+        view_info.subresourceRange.baseArrayLayer = 0;
+        view_info.subresourceRange.layerCount = _layer_count;
+
+        validate(
+            vkCreateImageView(_context->device, &view_info, nullptr, &_info.view),
+            "Failed to create texture array view."
+        );
+    }
+
+    void TextureArray::_create_sampler() {
+        // Tiles sit edge to edge, so clamp rather than repeat to avoid bleeding in the opposite border
+        _info.sampler = _context->sampler_cache->get(SamplerSettings::clamped());
+    }
+
+    void TextureArray::_initialize_layers() {
+        // Every layer must be in the layout the descriptor advertises, even before anything is uploaded to it
+        auto cmd = ScopedCommandBuffer(_context);
+        cmd.begin();
+
+        image::transition_layout(
+            cmd.get_command_buffer(),
+            _info.image,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            VK_ACCESS_2_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            0,
+            _mip_levels,
+            0,
+            _layer_count
+        );
+    }
+
+    void TextureArray::_validate_layer(const std::uint32_t layer) const {
+        if (layer >= _layer_count || !_allocated[layer]) {
+            throw std::runtime_error("Texture array layer has not been allocated.");
+        }
+    }
+}  // namespace fr
@@ -0,0 +1,115 @@
+#include "texture_batch_loader.h"
+#include "utils/scoped_command_buffer.h"
+
+#include <algorithm>
+
+namespace fr {
+    TextureBatchLoader::TextureBatchLoader(
+        const std::shared_ptr<VkContext>& context,
+        std::shared_ptr<TextureDiskCache> disk_cache,
+        const std::size_t n_threads
+    )
+        : _context(context)
+        , _disk_cache(std::move(disk_cache))
+        , _pool(n_threads)
+    { }
+
+    std::vector<std::unique_ptr<Texture>> TextureBatchLoader::load(const std::vector<std::filesystem::path>& paths, const std::size_t batch_size) {
+        std::vector<std::unique_ptr<Texture>> textures;
+        textures.reserve(paths.size());
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            textures.emplace_back(std::make_unique<Texture>(_context, _disk_cache));
+        }
+
+        // Workers report the index of each texture once its staging buffer is filled
+        std::mutex ready_mutex;
+        std::condition_variable ready_condition;
+        std::vector<std::size_t> ready;
+
+        const auto mark_ready = [&](const std::size_t i) {
+            {
+                std::lock_guard lock(ready_mutex);
+                ready.push_back(i);
+            }
+            ready_condition.notify_one();
+        };
+
+        std::vector<std::future<void>> decoded;
+        decoded.reserve(paths.size());
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            decoded.emplace_back(_pool.submit([&, i] {
+                try {
+                    textures[i]->prepare(paths[i]);
+                } catch (...) {
+                    mark_ready(i);
+                    throw;  // rethrown from the future on the calling thread
+                }
+                mark_ready(i);
+            }));
+        }
+
+        std::vector<Texture*> batch;
+        batch.reserve(batch_size);
+        std::exception_ptr error = nullptr;
+
+        for (std::size_t completed = 0; completed < paths.size();) {
+            std::vector<std::size_t> finished;
+            {
+                std::unique_lock lock(ready_mutex);
+                ready_condition.wait(lock, [&] { return !ready.empty(); });
+                finished.swap(ready);
+            }
+
+            for (const std::size_t i : finished) {
+                ++completed;
+
+                // Keep draining after a failure so no worker is left writing into a destroyed texture
+                try {
+                    decoded[i].get();
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    continue;
+                }
+
+                if (error) {
+                    continue;
+                }
+
+                batch.push_back(textures[i].get());
+                if (batch.size() >= std::max<std::size_t>(batch_size, 1)) {
+                    _submit_batch(batch);
+                }
+            }
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        if (!batch.empty()) {
+            _submit_batch(batch);
+        }
+
+        return textures;
+    }
+
+    void TextureBatchLoader::_submit_batch(std::vector<Texture*>& batch) {
+        // One submission for the whole batch, the scoped command buffer waits for completion when it goes out of scope
+        {
+            auto cmd = ScopedCommandBuffer(_context);
+            cmd.begin();
+
+            for (auto* texture : batch) {
+                texture->record_upload(cmd.get_command_buffer());
+            }
+        }
+
+        for (auto* texture : batch) {
+            texture->finish_upload();
+        }
+
+        batch.clear();
+    }
+}  // namespace fr
@@ -0,0 +1,255 @@
+#include "texture_cache.h"
+#include "texture_batch_loader.h"
+#include "utils/file_system.h"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+
+namespace fr {
+    TextureCache::TextureCache(
+        const std::shared_ptr<VkContext>& context,
+        const VkDeviceSize budget,
+        const bool hash_contents,
+        std::shared_ptr<TextureDiskCache> disk_cache
+    )
+        : _context(context)
+        , _disk_cache(std::move(disk_cache))
+        , _budget(budget)
+        , _hash_contents(hash_contents)
+    { }
+
+    TextureCache::~TextureCache() {
+        // Outstanding frames may still sample retired textures; wait once rather than per texture
+        vkDeviceWaitIdle(_context->device);
+
+        for (auto& [texture, frame] : _retired) {
+            texture->retire();
+        }
+        _retired.clear();
+
+        for (auto& [key, entry] : _entries) {
+            if (entry.texture.use_count() == 1) {
+                entry.texture->retire();
+            }
+        }
+    }
+
+    std::shared_ptr<Texture> TextureCache::acquire(const std::filesystem::path& path) {
+        const std::string key = _make_key(path);
+
+        const Lookup lookup = _find(path, key);
+        if (lookup.texture) {
+            return lookup.texture;
+        }
+
+        auto texture = std::make_shared<Texture>(_context, _disk_cache);
+        texture->load(path);
+
+        _insert(key, lookup, texture);
+        _evict();
+
+        return texture;
+    }
+
+    std::vector<std::shared_ptr<Texture>> TextureCache::acquire(const std::vector<std::filesystem::path>& paths) {
+        std::vector<std::shared_ptr<Texture>> textures(paths.size());
+        std::vector<std::string> keys(paths.size());
+
+        // Resolve hits first, collecting each distinct miss once
+        std::vector<std::filesystem::path> missing_paths;
+        std::vector<std::size_t> missing_indices;
+        std::vector<Lookup> missing_lookups;
+        std::unordered_map<std::string, std::size_t> missing_by_key;
+
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            keys[i] = _make_key(paths[i]);
+            if (missing_by_key.contains(keys[i])) {
+                continue;
+            }
+
+            Lookup lookup = _find(paths[i], keys[i]);
+            textures[i] = lookup.texture;
+            if (!textures[i]) {
+                missing_by_key[keys[i]] = missing_paths.size();
+                missing_paths.push_back(paths[i]);
+                missing_indices.push_back(i);
+                missing_lookups.push_back(std::move(lookup));
+            }
+        }
+
+        if (!missing_paths.empty()) {
+            auto loader = TextureBatchLoader(_context, _disk_cache);
+            auto loaded = loader.load(missing_paths);
+
+            for (std::size_t m = 0; m < loaded.size(); ++m) {
+                _insert(keys[missing_indices[m]], missing_lookups[m], std::shared_ptr<Texture>(std::move(loaded[m])));
+            }
+
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+                if (!textures[i]) {
+                    textures[i] = _entries.at(keys[i]).texture;
+                }
+            }
+        }
+
+        _evict();
+
+        return textures;
+    }
+
+    void TextureCache::set_budget(const VkDeviceSize budget) {
+        _budget = budget;
+        _evict();
+    }
+
+    void TextureCache::end_frame() {
+        ++_frame;
+
+        // Each swap chain image has its own command buffer, so that many frames may still reference a texture
+        const std::uint64_t frames_in_flight = std::max<std::size_t>(_context->per_frame.size(), 1);
+
+        while (!_retired.empty() && _retired.front().frame + frames_in_flight <= _frame) {
+            _retired.front().texture->retire();
+            _retired.pop_front();
+        }
+    }
+
+    VkDeviceSize TextureCache::resident_size() const {
+        return _resident_size;
+    }
+
+    std::size_t TextureCache::size() const {
+        return _entries.size();
+    }
+
+    std::string TextureCache::_make_key(const std::filesystem::path& path) {
+        return std::filesystem::weakly_canonical(std::filesystem::absolute(path)).string();
+    }
+
+    TextureCache::FileStamp TextureCache::_make_stamp(const std::filesystem::path& path) {
+        return FileStamp {
+            .mtime = std::filesystem::last_write_time(path),
+            .size  = std::filesystem::file_size(path)
+        };
+    }
+
+    TextureCache::Lookup TextureCache::_find(const std::filesystem::path& path, const std::string& key) {
+        Lookup lookup {
+            .stamp = _make_stamp(path)
+        };
+        std::optional<std::uint64_t> content_hash;
+
+        if (auto entry = _entries.find(key); entry != _entries.end()) {
+            // Unchanged files are never re-read
+            bool current = entry->second.stamp == lookup.stamp;
+            if (!current && _hash_contents) {
+                content_hash = file_system::hash_file(path);
+                current = *content_hash == entry->second.content_hash;
+            }
+
+            if (current) {
+                entry->second.stamp = lookup.stamp;
+                _lru.splice(_lru.begin(), _lru, entry->second.lru);
+                lookup.texture = entry->second.texture;
+                return lookup;
+            }
+
+            _remove(entry);
+        }
+
+        if (!_hash_contents) {
+            return lookup;
+        }
+
+        // A path already matched to another entry's contents
+        if (const auto alias = _aliases.find(key); alias != _aliases.end()) {
+            const auto target = _entries.find(alias->second.key);
+            if (alias->second.stamp == lookup.stamp && target != _entries.end() && target->second.content_hash == alias->second.content_hash) {
+                _lru.splice(_lru.begin(), _lru, target->second.lru);
+                lookup.texture = target->second.texture;
+                return lookup;
+            }
+
+            _aliases.erase(alias);
+        }
+
+        // Same image stored under a different path
+        lookup.content_hash = content_hash.has_value() ? *content_hash : file_system::hash_file(path);
+        if (const auto owner = _keys_by_hash.find(lookup.content_hash); owner != _keys_by_hash.end()) {
+            const auto target = _entries.find(owner->second);
+
+            _aliases[key] = Alias {
+                .key          = target->first,
+                .content_hash = lookup.content_hash,
+                .stamp        = lookup.stamp
+            };
+            _lru.splice(_lru.begin(), _lru, target->second.lru);
+            lookup.texture = target->second.texture;
+        }
+
+        return lookup;
+    }
+
+    void TextureCache::_insert(const std::string& key, const Lookup& lookup, std::shared_ptr<Texture> texture) {
+        // One entry and one LRU node per key
+        if (const auto existing = _entries.find(key); existing != _entries.end()) {
+            _remove(existing);
+        }
+
+        _lru.push_front(key);
+
+        const VkDeviceSize size = texture->get_memory_size();
+        _entries[key] = Entry {
+            .texture      = std::move(texture),
+            .content_hash = lookup.content_hash,
+            .stamp        = lookup.stamp,
+            .size         = size,
+            .lru          = _lru.begin()
+        };
+        _resident_size += size;
+
+        if (_hash_contents) {
+            _keys_by_hash[lookup.content_hash] = key;
+        }
+    }
+
+    void TextureCache::_remove(const std::unordered_map<std::string, Entry>::iterator entry) {
+        _resident_size -= entry->second.size;
+
+        // Textures with outstanding handles are destroyed by their last holder instead
+        if (entry->second.texture.use_count() == 1) {
+            _retired.push_back(Retired {
+                .texture = std::move(entry->second.texture),
+                .frame   = _frame
+            });
+        }
+
+        if (_hash_contents) {
+            const auto owner = _keys_by_hash.find(entry->second.content_hash);
+            if (owner != _keys_by_hash.end() && owner->second == entry->first) {
+                _keys_by_hash.erase(owner);
+            }
+        }
+
+        _lru.erase(entry->second.lru);
+        _entries.erase(entry);
+    }
+
+    void TextureCache::_evict() {
+        // Walk from the least recently used end; textures with outstanding handles are skipped
+        auto it = _lru.end();
+        while (_resident_size > _budget && it != _lru.begin()) {
+            --it;
+
+            const auto entry = _entries.find(*it);
+            if (entry->second.texture.use_count() > 1) {
+                continue;
+            }
+
+            const auto next = std::next(it);
+            _remove(entry);
+            it = next;
+        }
+    }
+}  // namespace fr
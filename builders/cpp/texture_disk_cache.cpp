@@ -0,0 +1,131 @@
+#include "texture_disk_cache.h"
+#include "utils/file_system.h"
+#include "utils/image_utils.h"
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace fr {
+    namespace {
+        /// Entries only ever hold the RGBA8 chains of the stb path, with every mip level down to 1x1
+        bool matches_layout(const DiskCacheHeader& header, const std::size_t file_size) {
+            if (header.format != VK_FORMAT_R8G8B8A8_SRGB && header.format != VK_FORMAT_R8G8B8A8_UNORM) {
+                return false;
+            }
+
+            if (header.width == 0 || header.height == 0 || header.mip_levels != image::calculate_mip_levels(header.width, header.height)) {
+                return false;
+            }
+
+            return header.payload_size == image::calculate_mip_chain_size(header.width, header.height, header.mip_levels, 4)
+                && sizeof(DiskCacheHeader) + header.payload_size == file_size;
+        }
+    }  // namespace
+
+    TextureDiskCache::TextureDiskCache(std::filesystem::path directory, const bool validate_contents)
+        : _directory(std::move(directory))
+        , _validate_contents(validate_contents)
+    {
+        std::filesystem::create_directories(_directory);
+    }
+
+    std::optional<CachedTexture> TextureDiskCache::find(const std::filesystem::path& source) const {
+        const auto entry_path = _entry_path(source);
+
+        std::error_code error;
+        if (!std::filesystem::exists(entry_path, error)) {
+            return std::nullopt;
+        }
+
+        auto file = file_system::MappedFile(entry_path);
+        if (file.size() < sizeof(DiskCacheHeader)) {
+            return std::nullopt;
+        }
+
+        DiskCacheHeader header;
+        std::memcpy(&header, file.data(), sizeof(DiskCacheHeader));
+
+        const DiskCacheHeader expected = _describe_source(source);
+        const bool valid =
+            header.magic        == DiskCacheHeader::expected_magic &&
+            header.version      == DiskCacheHeader::current_version &&
+            header.source_mtime == expected.source_mtime &&
+            header.source_size  == expected.source_size &&
+            header.source_hash  == expected.source_hash &&
+            matches_layout(header, file.size());
+
+        if (!valid) {
+            return std::nullopt;
+        }
+
+        return CachedTexture {
+            .header = header,
+            .file   = std::move(file)
+        };
+    }
+
+    void TextureDiskCache::store(
+        const std::filesystem::path& source,
+        const VkFormat format,
+        const std::uint32_t width,
+        const std::uint32_t height,
+        const std::vector<std::span<const std::uint8_t>>& mip_levels
+    ) const {
+        DiskCacheHeader header = _describe_source(source);
+        header.format     = format;
+        header.width      = width;
+        header.height     = height;
+        header.mip_levels = static_cast<std::uint32_t>(mip_levels.size());
+        for (const auto& level : mip_levels) {
+            header.payload_size += level.size();
+        }
+
+        std::vector<std::span<const std::byte>> parts;
+        parts.push_back(std::as_bytes(std::span(&header, 1)));
+        for (const auto& level : mip_levels) {
+            parts.push_back(std::as_bytes(level));
+        }
+
+        // Workers and other processes may store the same entry concurrently
+        file_system::write_file_atomically(_entry_path(source), parts);
+    }
+
+    void TextureDiskCache::store_async(
+        const std::filesystem::path& source,
+        const VkFormat format,
+        const std::uint32_t width,
+        const std::uint32_t height,
+        std::vector<std::uint8_t> base
+    ) {
+        _writer.submit([this, source, format, width, height, base = std::move(base)] {
+            try {
+                std::vector<std::uint8_t> chain;
+                const auto levels = image::generate_mip_chain_rgba8(
+                    base.data(), width, height, image::calculate_mip_levels(width, height), format, chain
+                );
+                store(source, format, width, height, levels);
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to cache " << source << ": " << e.what() << "\n";
+            }
+        });
+    }
+
+    std::filesystem::path TextureDiskCache::_entry_path(const std::filesystem::path& source) const {
+        const std::string key = std::filesystem::weakly_canonical(std::filesystem::absolute(source)).string();
+
+        std::ostringstream name;
+        name << std::hex << file_system::hash_bytes(key.data(), key.size()) << ".frtc";
+
+        return _directory / name.str();
+    }
+
+    DiskCacheHeader TextureDiskCache::_describe_source(const std::filesystem::path& source) const {
+        DiskCacheHeader header {};
+        header.source_mtime = std::filesystem::last_write_time(source).time_since_epoch().count();
+        header.source_size  = std::filesystem::file_size(source);
+        header.source_hash  = _validate_contents ? file_system::hash_file(source) : 0;
+
+        return header;
+    }
+}  // namespace fr
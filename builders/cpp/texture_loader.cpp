@@ -8,16 +8,25 @@
 
 #include "stb/stb_image.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <span>
+
 namespace fr {
-    Texture::Texture(const std::shared_ptr<VkContext>& context)
+    Texture::Texture(const std::shared_ptr<VkContext>& context, std::shared_ptr<TextureDiskCache> disk_cache)
         : _staging_buffer(&context->device, &context->allocator)
         , _context(context)
+        , _disk_cache(std::move(disk_cache))
     { }
 
     Texture::~Texture() {
-        vkDeviceWaitIdle(_context->device);
+        if (!_retired) {
+            vkDeviceWaitIdle(_context->device);
+        }
+
+        // The sampler is shared through the context's sampler cache
         vkDestroyImageView(_context->device, _info.view, nullptr);
-        vkDestroySampler(_context->device, _info.sampler, nullptr);
         vkDestroyImage(_context->device, _info.image, nullptr);
 
         _staging_buffer.destroy();
@@ -25,24 +34,86 @@ namespace fr {
     }
 
     void Texture::load(const std::filesystem::path& path) {
+        // Decode and allocate memory for the texture
+        prepare(path);
+
+        // Copy texture data from the staging buffer to the image in GPU
+        {
+            auto cmd = ScopedCommandBuffer(_context);
+            cmd.begin();
+            record_upload(cmd.get_command_buffer());
+        }
+
+        finish_upload();
+    }
+
+    void Texture::prepare(const std::filesystem::path& path) {
         if (!exists(path)) {
             throw std::runtime_error("Texture image path was not found.");
         }
 
-        // Load the texture
+        _path = path;
+
+        if (compressed_texture::is_container(path)) {
+            _prepare_compressed(path);
+            return;
+        }
+
+        if (_disk_cache) {
+            if (const auto cached = _disk_cache->find(path)) {
+                _prepare_cached(*cached);
+                return;
+            }
+        }
+
+        // Decode with the image's own channel count, the RGBA expansion is done while filling the staging buffer
         int width, height, channels;
-        _data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        _data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+        if (_data == nullptr) {
+            throw std::runtime_error("Failed to decode texture image.");
+        }
+
+        _channels = channels;
+
+        _width  = width;
+        _height = height;
         _info.size = width * height * 4;
 
+        _mip_levels = image::calculate_mip_levels(width, height);
+
+        // With a disk cache the GPU still builds the mips; the entry's chain is filtered separately, off the load path
+        _blit_mipmaps = _supports_blit(_format);
+
         // Allocate memory and create required resources for texture loading
         _prepare_resources(width, height);
+    }
 
-        // Copy texture data from the staging buffer to the image in GPU
-        _copy_data(width, height);
-
+    void Texture::finish_upload() {
         _create_sampler();
 
         _create_view();
+
+        // The upload has completed, the staging memory is no longer needed
+        _staging_buffer.destroy();
+        _copy_regions.clear();
+    }
+
+    void Texture::_prepare_compressed(const std::filesystem::path& path) {
+        const CompressedImage compressed = compressed_texture::load(path);
+
+        if (!_supports_sampling(compressed.format)) {
+            throw std::runtime_error("Block compressed texture format is not supported by the physical device.");
+        }
+
+        // Mips come pre-built in the container; block formats cannot be blitted so nothing is generated here
+        _format       = compressed.format;
+        _width        = compressed.width;
+        _height       = compressed.height;
+        _mip_levels   = static_cast<std::uint32_t>(compressed.mip_levels.size());
+        _blit_mipmaps = false;
+        _info.size    = compressed.payload_size();
+
+        _prepare_compressed_resources(compressed);
     }
 
     TextureInfo Texture::get_info() {
@@ -54,24 +125,29 @@ namespace fr {
         return _info;
     }
 
-    void Texture::_prepare_resources(const std::uint32_t width, const std::uint32_t height) {
-        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+    VkDeviceSize Texture::get_memory_size() const {
+        return _memory_size;
+    }
 
-        // Create the texture image
+    void Texture::retire() {
+        _retired = true;
+    }
+
+    void Texture::_create_image(const std::uint32_t width, const std::uint32_t height, const VkImageUsageFlags usage) {
         VkImageCreateInfo image_info {
             .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
             .imageType = VK_IMAGE_TYPE_2D,
-            .format = format,
+            .format = _format,
             .extent = {
                 .width = width,
                 .height = height,
                 .depth = 1
             },
-            .mipLevels = 1,
+            .mipLevels = _mip_levels,
             .arrayLayers = 1,
             .samples = VK_SAMPLE_COUNT_1_BIT,
             .tiling = VK_IMAGE_TILING_OPTIMAL,
-            .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            .usage = usage,
             .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
             .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
         };
@@ -86,37 +162,117 @@ namespace fr {
             "Failed to create image."
         );
 
-        // Create the staging buffer
+        _memory_size = alloc_info.size;
+    }
+
+    void Texture::_prepare_resources(const std::uint32_t width, const std::uint32_t height) {
+        // Create the texture image
+        _create_image(width, height, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        // Create the staging buffer: only the base level when the GPU builds the mips, otherwise the full chain
         auto buffer_utils = BufferUtils(_context);
-        buffer_utils.create_staging_buffer(_staging_buffer, width * height * 4);
-        vmaCopyMemoryToAllocation(_context->allocator, _data, _staging_buffer.allocation, 0, width * height * 4);
+        const auto* decoded = static_cast<const std::uint8_t*>(_data);
+        const std::size_t texel_count = static_cast<std::size_t>(width) * height;
+
+        if (_blit_mipmaps && _disk_cache) {
+            // The cache writer keeps its own RGBA copy of the base level to filter the entry's chain from
+            std::vector<std::uint8_t> rgba(texel_count * 4);
+            image::expand_to_rgba8(decoded, _channels, texel_count, rgba.data());
+
+            buffer_utils.create_staging_buffer(_staging_buffer, rgba.size());
+            validate(
+                vmaCopyMemoryToAllocation(_context->allocator, rgba.data(), _staging_buffer.allocation, 0, rgba.size()),
+                "Failed to copy texture to the staging buffer."
+            );
+
+            _disk_cache->store_async(_path, _format, width, height, std::move(rgba));
+        } else if (_blit_mipmaps) {
+            // Texels are expanded straight into the mapped staging memory, without an intermediate RGBA image
+            buffer_utils.create_staging_buffer(_staging_buffer, texel_count * 4);
+
+            auto* staging = static_cast<std::uint8_t*>(buffer_utils.map_buffer(_staging_buffer));
+            image::expand_to_rgba8(decoded, _channels, texel_count, staging);
+            buffer_utils.unmap_buffer(_staging_buffer);
+        } else {
+            // The CPU chain is filtered from host memory, so the base level needs an RGBA copy unless it was decoded as one
+            std::vector<std::uint8_t> rgba;
+            if (_channels != 4) {
+                rgba.resize(texel_count * 4);
+                image::expand_to_rgba8(decoded, _channels, texel_count, rgba.data());
+                decoded = rgba.data();
+            }
+
+            buffer_utils.create_staging_buffer(_staging_buffer, image::calculate_mip_chain_size(width, height, _mip_levels, 4));
+            _fill_staging_mip_chain(decoded, width, height);
+        }
 
         stbi_image_free(_data);
+        _data = nullptr;
+
+        // Copy regions: the base level only when blitting, every level of the CPU filtered chain otherwise
+        _add_mip_chain_regions(width, height, _blit_mipmaps ? 1 : _mip_levels);
     }
 
-    void Texture::_copy_data(const std::uint32_t width, const std::uint32_t height) {
-        auto cmd = ScopedCommandBuffer(_context);
-        cmd.begin();
+    void Texture::_prepare_cached(const CachedTexture& cached) {
+        // Decoded texels and their mips come straight from the mapped cache entry
+        _format       = static_cast<VkFormat>(cached.header.format);
+        _width        = cached.header.width;
+        _height       = cached.header.height;
+        _mip_levels   = cached.header.mip_levels;
+        _blit_mipmaps = false;
+        _info.size    = static_cast<std::size_t>(_width) * _height * 4;
 
-        image::transition_layout(
-            cmd.get_command_buffer(),
-            _info.image,
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            0,                                      // srcAccessMask (no need to wait for previous operations)
-            VK_ACCESS_TRANSFER_WRITE_BIT,           // dstAccessMask
-            VK_PIPELINE_STAGE_HOST_BIT,             // srcStage
-            VK_PIPELINE_STAGE_TRANSFER_BIT          // dstStage
+        _create_image(_width, _height, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        auto buffer_utils = BufferUtils(_context);
+        buffer_utils.create_staging_buffer(_staging_buffer, cached.header.payload_size);
+        validate(
+            vmaCopyMemoryToAllocation(_context->allocator, cached.payload(), _staging_buffer.allocation, 0, cached.header.payload_size),
+            "Failed to copy cached texture to the staging buffer."
         );
 
-        // Copy buffer to image
+        _add_mip_chain_regions(_width, _height, _mip_levels);
+    }
+
+    void Texture::_add_mip_chain_regions(std::uint32_t width, std::uint32_t height, const std::uint32_t levels) {
+        VkDeviceSize offset = 0;
+        for (std::uint32_t mip = 0; mip < levels; ++mip) {
+            _add_copy_region(offset, mip, width, height);
+
+            offset += static_cast<VkDeviceSize>(width) * height * 4;
+            width  = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+    }
+
+    void Texture::_prepare_compressed_resources(const CompressedImage& compressed) {
+        _create_image(compressed.width, compressed.height, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+        auto buffer_utils = BufferUtils(_context);
+        buffer_utils.create_staging_buffer(_staging_buffer, compressed.payload_size());
+
+        // Blocks are copied as-is; each level size is a multiple of the block size so offsets stay block aligned
+        VkDeviceSize offset = 0;
+        for (std::uint32_t mip = 0; mip < _mip_levels; ++mip) {
+            const CompressedMipLevel& level = compressed.mip_levels[mip];
+
+            validate(
+                vmaCopyMemoryToAllocation(_context->allocator, compressed.data.data() + level.offset, _staging_buffer.allocation, offset, level.size),
+                "Failed to copy compressed texture blocks to the staging buffer."
+            );
+
+            _add_copy_region(offset, mip, level.width, level.height);
+            offset += level.size;
+        }
+    }
+
+    void Texture::_add_copy_region(const VkDeviceSize offset, const std::uint32_t mip_level, const std::uint32_t width, const std::uint32_t height) {
         VkBufferImageCopy region {};
-        region.bufferOffset = 0;
+        region.bufferOffset = offset;
         region.bufferRowLength = 0;   // 0 means tightly packed
         region.bufferImageHeight = 0; // 0 means tightly packed
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.mipLevel = mip_level;
         region.imageSubresource.baseArrayLayer = 0;
         region.imageSubresource.layerCount = 1;
         region.imageOffset = {0, 0, 0};
@@ -126,17 +282,71 @@ namespace fr {
             1
         };
 
+        _copy_regions.push_back(region);
+    }
+
+    void Texture::_fill_staging_mip_chain(const std::uint8_t* base, const std::uint32_t width, const std::uint32_t height) {
+        const std::size_t base_size = static_cast<std::size_t>(width) * height * 4;
+
+        // Levels 1..n are filtered in host memory: staging memory is write-combined and must never be read back
+        std::vector<std::uint8_t> chain;
+        const auto levels = image::generate_mip_chain_rgba8(base, width, height, _mip_levels, _format, chain);
+
+        // The chain is laid out contiguously after the base level, matching the staging layout
+        validate(
+            vmaCopyMemoryToAllocation(_context->allocator, base, _staging_buffer.allocation, 0, base_size),
+            "Failed to copy texture to the staging buffer."
+        );
+        if (!chain.empty()) {
+            validate(
+                vmaCopyMemoryToAllocation(_context->allocator, chain.data(), _staging_buffer.allocation, base_size, chain.size()),
+                "Failed to copy texture mips to the staging buffer."
+            );
+        }
+
+        // The cache is an optimisation: a failed write must not fail the load
+        if (_disk_cache) {
+            try {
+                _disk_cache->store(_path, _format, _width, _height, levels);
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to cache " << _path << ": " << e.what() << "\n";
+            }
+        }
+    }
+
+    void Texture::record_upload(VkCommandBuffer cmd) {
+        image::transition_layout(
+            cmd,
+            _info.image,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,                                      // srcAccessMask (no need to wait for previous operations)
+            VK_ACCESS_TRANSFER_WRITE_BIT,           // dstAccessMask
+            VK_PIPELINE_STAGE_HOST_BIT,             // srcStage
+            VK_PIPELINE_STAGE_TRANSFER_BIT,         // dstStage
+            0,
+            _mip_levels
+        );
+
+        // Copy buffer to image
         vkCmdCopyBufferToImage(
-            cmd.get_command_buffer(),
+            cmd,
             _staging_buffer.buffer,
             _info.image,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region
+            static_cast<std::uint32_t>(_copy_regions.size()),
+            _copy_regions.data()
         );
 
+        if (_blit_mipmaps) {
+            // Leaves every level in SHADER_READ_ONLY_OPTIMAL
+            image::generate_mipmaps(cmd, _info.image, _width, _height, _mip_levels);
+            return;
+        }
+
         image::transition_layout(
-            cmd.get_command_buffer(),
+            cmd,
             _info.image,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
@@ -144,31 +354,38 @@ namespace fr {
             VK_ACCESS_TRANSFER_WRITE_BIT,               // srcAccessMask (no need to wait for previous operations)
             VK_ACCESS_SHADER_READ_BIT,                  // dstAccessMask
             VK_PIPELINE_STAGE_TRANSFER_BIT,             // srcStage
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT       // dstStage
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,      // dstStage
+            0,
+            _mip_levels
         );
     }
 
-    void Texture::_create_sampler() {
-        // Calculate valid filter and mipmap modes
-        VkFilter            filter      = VK_FILTER_LINEAR;
-        VkSamplerMipmapMode mipmap_mode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-
-        VkSamplerCreateInfo sampler_info {};
-        sampler_info.sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-        sampler_info.magFilter    = filter;
-        sampler_info.minFilter    = filter;
-        sampler_info.mipmapMode   = mipmap_mode;
-        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-        sampler_info.mipLodBias   = 0.0f;
-        sampler_info.compareOp    = VK_COMPARE_OP_NEVER;
-        sampler_info.minLod       = 0.0f;
+    bool Texture::_supports_blit(const VkFormat format) const {
+        return image::supports_linear_blit(_context->gpu, format);
+    }
 
-        validate(
-            vkCreateSampler(_context->device, &sampler_info, nullptr, &_info.sampler),
-            "Failed to create texture sampler."
-        );
+    bool Texture::_supports_sampling(const VkFormat format) const {
+        VkFormatProperties format_properties;
+        vkGetPhysicalDeviceFormatProperties(_context->gpu, format, &format_properties);
+
+        constexpr VkFormatFeatureFlags required_features =
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+            VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+
+        return (format_properties.optimalTilingFeatures & required_features) == required_features;
+    }
+
+    void Texture::set_sampler(const SamplerSettings& settings) {
+        _sampler_settings = settings;
+
+        // Already uploaded: swap the handle, descriptors built from get_info() must be rewritten by the caller
+        if (_info.sampler != VK_NULL_HANDLE) {
+            _create_sampler();
+        }
+    }
+
+    void Texture::_create_sampler() {
+        _info.sampler = _context->sampler_cache->get(_sampler_settings);
     }
 
     void Texture::_create_view() {
@@ -176,10 +393,10 @@ namespace fr {
         view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         view_info.image = _info.image;
         view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        view_info.format = VK_FORMAT_R8G8B8A8_SRGB;
+        view_info.format = _format;
         view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         view_info.subresourceRange.baseMipLevel = 0;
-        view_info.subresourceRange.levelCount = 1;
+        view_info.subresourceRange.levelCount = _mip_levels;
         view_info.subresourceRange.baseArrayLayer = 0;
         view_info.subresourceRange.layerCount = 1;
 
@@ -0,0 +1,484 @@
+#include "texture_streamer.h"
+#include "utils/buffer_utils.h"
+#include "utils/error.h"
+#include "utils/scoped_command_buffer.h"
+#include "utils/image_utils.h"
+
+#include "stb/stb_image.h"
+
+#include <algorithm>
+
+namespace fr {
+    StreamedTexture::StreamedTexture(const std::shared_ptr<VkContext>& context)
+        : _context(context)
+    { }
+
+    StreamedTexture::~StreamedTexture() {
+        vkDeviceWaitIdle(_context->device);
+
+        vkDestroyImageView(_context->device, _info.view, nullptr);
+        vmaDestroyImage(_context->allocator, _info.image, _allocation);
+    }
+
+    TextureInfo StreamedTexture::get_info() {
+        _info.image_info = {
+            .sampler     = _info.sampler,
+            .imageView   = _info.view,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        };
+        return _info;
+    }
+
+    std::uint32_t StreamedTexture::get_resident_level() const {
+        return _resident_level;
+    }
+
+    float StreamedTexture::get_min_lod() const {
+        return static_cast<float>(_resident_level);
+    }
+
+    bool StreamedTexture::is_complete() const {
+        return _resident_level == 0;
+    }
+
+    std::uint32_t StreamedTexture::_level_width(const std::uint32_t level) const {
+        return std::max(_width >> level, 1u);
+    }
+
+    std::uint32_t StreamedTexture::_level_height(const std::uint32_t level) const {
+        return std::max(_height >> level, 1u);
+    }
+
+    void StreamedTexture::_make_resident(const std::uint32_t level) {
+        _resident_level = level;
+
+        if (level == 0) {
+            _levels.clear();
+            _chain = {};
+            _base = {};
+        }
+    }
+
+    TextureStreamer::TextureStreamer(const std::shared_ptr<VkContext>& context, const VkDeviceSize frame_budget, const std::uint32_t tail_size)
+        : _context(context)
+        , _frame_budget(frame_budget)
+        , _tail_size(std::max(tail_size, 1u))
+    {
+        _create_frames();
+    }
+
+    TextureStreamer::~TextureStreamer() {
+        vkDeviceWaitIdle(_context->device);
+
+        for (auto& frame : _frames) {
+            vkDestroyFence(_context->device, frame.fence, nullptr);
+            vkFreeCommandBuffers(_context->device, frame.command_pool, 1, &frame.command_buffer);
+            vkDestroyCommandPool(_context->device, frame.command_pool, nullptr);
+        }
+    }
+
+    std::shared_ptr<StreamedTexture> TextureStreamer::load(const std::filesystem::path& path, const SamplerSettings& sampler_settings) {
+        if (!exists(path)) {
+            throw std::runtime_error("Texture image path was not found.");
+        }
+
+        int width, height, channels;
+        const std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> data(
+            stbi_load(path.c_str(), &width, &height, &channels, 0),
+            stbi_image_free
+        );
+        if (data == nullptr) {
+            throw std::runtime_error("Failed to decode texture image.");
+        }
+
+        auto texture = std::shared_ptr<StreamedTexture>(new StreamedTexture(_context));
+        texture->_info.sampler = _context->sampler_cache->get(sampler_settings);
+        texture->_width      = width;
+        texture->_height     = height;
+        texture->_mip_levels = image::calculate_mip_levels(width, height);
+        texture->_base.resize(static_cast<std::size_t>(width) * height * 4);
+        image::expand_to_rgba8(data.get(), channels, static_cast<std::size_t>(width) * height, texture->_base.data());
+        texture->_levels     = image::generate_mip_chain_rgba8(texture->_base.data(), width, height, texture->_mip_levels, texture->_format, texture->_chain);
+
+        // The tail is every level no larger than tail_size, it is uploaded before load() returns
+        std::uint32_t tail_level = 0;
+        while (tail_level + 1 < texture->_mip_levels && std::max(texture->_level_width(tail_level), texture->_level_height(tail_level)) > _tail_size) {
+            ++tail_level;
+        }
+
+        VkImageCreateInfo image_info {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = texture->_format,
+            .extent = {
+                .width = texture->_width,
+                .height = texture->_height,
+                .depth = 1
+            },
+            .mipLevels = texture->_mip_levels,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        VmaAllocationCreateInfo alloc_create_info {
+            .usage = VMA_MEMORY_USAGE_GPU_ONLY
+        };
+
+        VmaAllocationInfo alloc_info;
+        validate(
+            vmaCreateImage(_context->allocator, &image_info, &alloc_create_info, &texture->_info.image, &texture->_allocation, &alloc_info),
+            "Failed to create streamed texture image."
+        );
+        texture->_info.size = alloc_info.size;
+
+        VkImageViewCreateInfo view_info {};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = texture->_info.image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = texture->_format;
+        view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        view_info.subresourceRange.baseMipLevel = 0;
+        view_info.subresourceRange.levelCount = texture->_mip_levels;
+        view_info.subresourceRange.baseArrayLayer = 0;
+        view_info.subresourceRange.layerCount = 1;
+
+        validate(
+            vkCreateImageView(_context->device, &view_info, nullptr, &texture->_info.view),
+            "Failed to create streamed texture view."
+        );
+
+        // Stage the tail, coarse levels are packed at the end of the chain
+        VkDeviceSize tail_size = 0;
+        for (std::uint32_t level = tail_level; level < texture->_mip_levels; ++level) {
+            tail_size += texture->_levels[level].size();
+        }
+
+        auto buffer_utils = BufferUtils(_context);
+        auto staging_buffer = BufferCore(&_context->device, &_context->allocator);
+        buffer_utils.create_staging_buffer(staging_buffer, tail_size);
+
+        std::vector<VkBufferImageCopy> regions;
+        VkDeviceSize offset = 0;
+        for (std::uint32_t level = tail_level; level < texture->_mip_levels; ++level) {
+            validate(
+                vmaCopyMemoryToAllocation(_context->allocator, texture->_levels[level].data(), staging_buffer.allocation, offset, texture->_levels[level].size()),
+                "Failed to copy texture mip tail to the staging buffer."
+            );
+
+            VkBufferImageCopy region {};
+            region.bufferOffset = offset;
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+            region.imageExtent = {texture->_level_width(level), texture->_level_height(level), 1};
+            regions.push_back(region);
+
+            offset += texture->_levels[level].size();
+        }
+
+        {
+            auto cmd = ScopedCommandBuffer(_context);
+            cmd.begin();
+
+            // Levels that are streamed later start in SHADER_READ_ONLY so the whole view matches its descriptor layout
+            if (tail_level > 0) {
+                image::transition_layout(
+                    cmd.get_command_buffer(),
+                    texture->_info.image,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    0,
+                    VK_ACCESS_2_SHADER_READ_BIT,
+                    VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                    VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                    0,
+                    tail_level
+                );
+            }
+
+            image::transition_layout(
+                cmd.get_command_buffer(),
+                texture->_info.image,
+                VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                tail_level,
+                texture->_mip_levels - tail_level
+            );
+
+            vkCmdCopyBufferToImage(
+                cmd.get_command_buffer(),
+                staging_buffer.buffer,
+                texture->_info.image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<std::uint32_t>(regions.size()),
+                regions.data()
+            );
+
+            image::transition_layout(
+                cmd.get_command_buffer(),
+                texture->_info.image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_ACCESS_2_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                tail_level,
+                texture->_mip_levels - tail_level
+            );
+        }
+
+        texture->_make_resident(tail_level);
+        if (tail_level > 0) {
+            texture->_next_level    = tail_level - 1;
+            texture->_recorded_rows = 0;
+            texture->_recorded_all  = false;
+            _streaming.push_back(texture);
+        }
+
+        return texture;
+    }
+
+    std::vector<std::shared_ptr<StreamedTexture>> TextureStreamer::update() {
+        std::vector<StreamedTexture*> refined_levels;
+        UploadFrame& frame = _frames[_frame % _frames.size()];
+
+        // Levels recorded the last time this frame was used are now complete
+        if (frame.submitted) {
+            validate(
+                vkWaitForFences(_context->device, 1, &frame.fence, VK_TRUE, UINT64_MAX),
+                "Failed to wait for the texture streaming fence."
+            );
+            validate(vkResetFences(_context->device, 1, &frame.fence), "Failed to reset the texture streaming fence.");
+
+            for (auto& [texture, level] : frame.completed) {
+                texture->_make_resident(level);
+
+                if (std::find(refined_levels.begin(), refined_levels.end(), texture.get()) == refined_levels.end()) {
+                    refined_levels.push_back(texture.get());
+                }
+            }
+
+            frame.completed.clear();
+            frame.submitted = false;
+        }
+
+        // Every texture with a completed level is still streaming; the ones the caller has released are not reported
+        std::vector<std::shared_ptr<StreamedTexture>> refined;
+        for (const StreamedTexture* texture : refined_levels) {
+            const auto owner = std::find_if(_streaming.begin(), _streaming.end(), [&](const auto& streamed) { return streamed.get() == texture; });
+            if (owner->use_count() > 1) {
+                refined.push_back(*owner);
+            }
+        }
+
+        // Textures held by nothing but the streamer (and no in-flight upload) are released instead of being finished
+        std::erase_if(_streaming, [](const std::shared_ptr<StreamedTexture>& texture) {
+            return texture->is_complete() || texture.use_count() == 1;
+        });
+
+        const std::vector<UploadBand> bands = _plan_bands();
+        if (!bands.empty()) {
+            _record_bands(frame, bands);
+
+            VkSubmitInfo submit_info {
+                .sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                .commandBufferCount = 1,
+                .pCommandBuffers    = &frame.command_buffer
+            };
+
+            validate(
+                vkQueueSubmit(_context->queue, 1, &submit_info, frame.fence),
+                "Failed to submit texture streaming uploads."
+            );
+            frame.submitted = true;
+        }
+
+        ++_frame;
+        return refined;
+    }
+
+    void TextureStreamer::set_frame_budget(const VkDeviceSize frame_budget) {
+        _frame_budget = frame_budget;
+    }
+
+    std::size_t TextureStreamer::pending() const {
+        return _streaming.size();
+    }
+
+    void TextureStreamer::_create_frames() {
+        _frames.resize(std::max<std::size_t>(_context->per_frame.size(), 1));
+
+        for (auto& frame : _frames) {
+            VkCommandPoolCreateInfo command_pool_info {
+                .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                .queueFamilyIndex = static_cast<std::uint32_t>(_context->graphics_queue_index)
+            };
+            validate(
+                vkCreateCommandPool(_context->device, &command_pool_info, nullptr, &frame.command_pool),
+                "Failed to create texture streaming command pool."
+            );
+
+            VkCommandBufferAllocateInfo alloc_info {
+                .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool        = frame.command_pool,
+                .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                .commandBufferCount = 1
+            };
+            validate(
+                vkAllocateCommandBuffers(_context->device, &alloc_info, &frame.command_buffer),
+                "Failed to allocate texture streaming command buffer."
+            );
+
+            VkFenceCreateInfo fence_info {
+                .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+            };
+            validate(
+                vkCreateFence(_context->device, &fence_info, nullptr, &frame.fence),
+                "Failed to create texture streaming fence."
+            );
+
+            frame.staging = std::make_unique<BufferCore>(&_context->device, &_context->allocator);
+        }
+    }
+
+    std::vector<TextureStreamer::UploadBand> TextureStreamer::_plan_bands() {
+        std::vector<UploadBand> bands;
+        std::vector<StreamedTexture*> candidates;
+        for (const auto& texture : _streaming) {
+            if (!texture->_recorded_all) {
+                candidates.push_back(texture.get());
+            }
+        }
+
+        VkDeviceSize budget = _frame_budget;
+        VkDeviceSize offset = 0;
+        while (!candidates.empty()) {
+            // Coarsest outstanding level first, so every texture sharpens at the same pace
+            const auto next = std::max_element(candidates.begin(), candidates.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+                return a->_next_level < b->_next_level;
+            });
+            StreamedTexture* texture = *next;
+
+            const std::uint32_t level     = texture->_next_level;
+            const VkDeviceSize  row_size  = static_cast<VkDeviceSize>(texture->_level_width(level)) * 4;
+            const std::uint32_t remaining = texture->_level_height(level) - texture->_recorded_rows;
+
+            auto rows = static_cast<std::uint32_t>(std::min<VkDeviceSize>(remaining, budget / row_size));
+            if (rows == 0) {
+                if (!bands.empty()) {
+                    break;  // Budget spent
+                }
+                rows = 1;   // A budget smaller than one row still makes progress
+            }
+
+            bands.push_back(UploadBand {
+                .texture        = texture,
+                .level          = level,
+                .first_row      = texture->_recorded_rows,
+                .rows           = rows,
+                .staging_offset = offset
+            });
+
+            const VkDeviceSize size = rows * row_size;
+            offset += size;
+            budget  = budget > size ? budget - size : 0;
+
+            texture->_recorded_rows += rows;
+            if (texture->_recorded_rows == texture->_level_height(level)) {
+                if (level == 0) {
+                    texture->_recorded_all = true;
+                    candidates.erase(next);
+                } else {
+                    texture->_next_level    = level - 1;
+                    texture->_recorded_rows = 0;
+                }
+            }
+        }
+
+        return bands;
+    }
+
+    void TextureStreamer::_record_bands(UploadFrame& frame, const std::vector<UploadBand>& bands) {
+        const VkDeviceSize staging_size = bands.back().staging_offset
+            + static_cast<VkDeviceSize>(bands.back().texture->_level_width(bands.back().level)) * 4 * bands.back().rows;
+
+        if (frame.staging->size < staging_size) {
+            frame.staging->destroy();
+
+            auto buffer_utils = BufferUtils(_context);
+            buffer_utils.create_staging_buffer(*frame.staging, std::max(staging_size, _frame_budget));
+        }
+
+        validate(vkResetCommandPool(_context->device, frame.command_pool, 0), "Failed to reset texture streaming command pool.");
+
+        VkCommandBufferBeginInfo begin_info {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        };
+        validate(vkBeginCommandBuffer(frame.command_buffer, &begin_info), "Failed to begin texture streaming command buffer.");
+
+        for (const auto& [texture, level, first_row, rows, staging_offset] : bands) {
+            const std::uint32_t width    = texture->_level_width(level);
+            const VkDeviceSize  row_size = static_cast<VkDeviceSize>(width) * 4;
+
+            validate(
+                vmaCopyMemoryToAllocation(_context->allocator, texture->_levels[level].data() + first_row * row_size, frame.staging->allocation, staging_offset, rows * row_size),
+                "Failed to copy texture rows to the staging buffer."
+            );
+
+            // The first band discards the level, later bands must keep the rows already written
+            image::transition_layout(
+                frame.command_buffer,
+                texture->_info.image,
+                first_row == 0 ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                level
+            );
+
+            VkBufferImageCopy region {};
+            region.bufferOffset = staging_offset;
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+            region.imageOffset = {0, static_cast<std::int32_t>(first_row), 0};
+            region.imageExtent = {width, rows, 1};
+
+            vkCmdCopyBufferToImage(frame.command_buffer, frame.staging->buffer, texture->_info.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+            image::transition_layout(
+                frame.command_buffer,
+                texture->_info.image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_ACCESS_2_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                level
+            );
+
+            // The level becomes resident once the frame's fence signals
+            if (first_row + rows == texture->_level_height(level)) {
+                const auto owner = std::find_if(_streaming.begin(), _streaming.end(), [&](const auto& streamed) { return streamed.get() == texture; });
+                frame.completed.push_back(CompletedLevel {*owner, level});
+            }
+        }
+
+        validate(vkEndCommandBuffer(frame.command_buffer), "Failed to end texture streaming command buffer.");
+    }
+}  // namespace fr
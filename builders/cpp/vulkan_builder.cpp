@@ -2,8 +2,10 @@
 
 #include "vulkan_builder.h"
 #include "texture_loader.h"
+#include "drawing/descriptor_allocator.h"
 #include "utils/error.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace fr {
@@ -20,6 +22,9 @@ namespace fr {
         _create_surface();
         _create_device();
         _create_memory_allocator();
+        _create_sampler_cache();
+        _create_descriptor_allocators();
+        _create_pipeline_cache();
         _load_device_extensions();
         _create_swap_chain();
         _create_depth_resources();
@@ -55,6 +60,12 @@ namespace fr {
         return all_found;
     }
 
+    bool VulkanBuilder::_has_extension(const char* name, const std::vector<VkExtensionProperties>& available) {
+        return std::any_of(available.begin(), available.end(), [name](const auto& extension) {
+            return strcmp(extension.extensionName, name) == 0;
+        });
+    }
+
     VkBool32 _debug_callback(
         VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
         VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -70,6 +81,19 @@ namespace fr {
         if (system::enable_validation_layers)
             requested_layers = vulkan::validation_layers;
 
+        // Emulates VK_EXT_shader_object on drivers without it, and steps aside on drivers that have it
+        std::uint32_t layer_count = 0;
+        vkEnumerateInstanceLayerProperties(&layer_count, nullptr);
+
+        std::vector<VkLayerProperties> available_layers(layer_count);
+        vkEnumerateInstanceLayerProperties(&layer_count, available_layers.data());
+
+        const bool has_shader_object_layer = std::any_of(available_layers.begin(), available_layers.end(), [](const auto& layer) {
+            return strcmp(layer.layerName, vulkan::shader_object_layer) == 0;
+        });
+        if (has_shader_object_layer) {
+            requested_layers.push_back(vulkan::shader_object_layer);
+        }
 
         return requested_layers;
     }
@@ -194,13 +218,35 @@ namespace fr {
         if (!_validate_extensions(required_device_extensions, device_extensions))
             throw std::runtime_error("Failed to find all required device extensions on the selected physical device.");
 
+        // Optional extensions are enabled when present, callers check VkContext::features before using them
+        _context->features.push_descriptor = _has_extension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, device_extensions);
+        if (_context->features.push_descriptor) {
+            required_device_extensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+        }
+
+        const bool has_descriptor_buffer = _has_extension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, device_extensions);
+        const bool has_shader_object = _has_extension(VK_EXT_SHADER_OBJECT_EXTENSION_NAME, device_extensions);
+
         // Query for Vulkan 1.3 features
         VkPhysicalDeviceFeatures2 query_device_features2 { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        VkPhysicalDeviceVulkan12Features query_vulkan12_features { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
         VkPhysicalDeviceVulkan13Features query_vulkan13_features { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES };
         VkPhysicalDeviceExtendedDynamicStateFeaturesEXT query_extended_dynamic_state_features { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT };
-        query_device_features2.pNext = &query_vulkan13_features;
+        query_device_features2.pNext = &query_vulkan12_features;
+        query_vulkan12_features.pNext = &query_vulkan13_features;
         query_vulkan13_features.pNext = &query_extended_dynamic_state_features;
 
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT query_descriptor_buffer_features { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT };
+        if (has_descriptor_buffer) {
+            query_extended_dynamic_state_features.pNext = &query_descriptor_buffer_features;
+        }
+
+        VkPhysicalDeviceShaderObjectFeaturesEXT query_shader_object_features { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT };
+        if (has_shader_object) {
+            query_shader_object_features.pNext = query_extended_dynamic_state_features.pNext;
+            query_extended_dynamic_state_features.pNext = &query_shader_object_features;
+        }
+
         vkGetPhysicalDeviceFeatures2(_context->gpu, &query_device_features2);
 
         if (!query_vulkan13_features.dynamicRendering)
@@ -212,9 +258,55 @@ namespace fr {
         if (!query_extended_dynamic_state_features.extendedDynamicState)
             throw std::runtime_error("Extended Dynamic State is not supported.");
 
+        // Shaders need 64-bit integers to work with device addresses. Without them buffers are only reachable
+        //      through descriptor bindings.
+        _context->features.buffer_device_address =
+            query_vulkan12_features.bufferDeviceAddress &&
+            query_device_features2.features.shaderInt64;
+
+        // Bindless texture tables are optional, every feature they rely on must be present
+        _context->features.descriptor_indexing =
+            query_vulkan12_features.descriptorIndexing &&
+            query_vulkan12_features.runtimeDescriptorArray &&
+            query_vulkan12_features.descriptorBindingPartiallyBound &&
+            query_vulkan12_features.descriptorBindingVariableDescriptorCount &&
+            query_vulkan12_features.descriptorBindingSampledImageUpdateAfterBind &&
+            query_vulkan12_features.descriptorBindingUpdateUnusedWhilePending &&
+            query_vulkan12_features.shaderSampledImageArrayNonUniformIndexing;
+
+        _context->features.sampler_anisotropy = query_device_features2.features.samplerAnisotropy;
+
+        // Descriptor buffers are bound by device address
+        _context->features.descriptor_buffer =
+            has_descriptor_buffer &&
+            query_descriptor_buffer_features.descriptorBuffer &&
+            _context->features.buffer_device_address;
+        if (_context->features.descriptor_buffer) {
+            required_device_extensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        }
+
+        _context->features.shader_object = has_shader_object && query_shader_object_features.shaderObject;
+        if (_context->features.shader_object) {
+            required_device_extensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+        }
+
         // Enable the specific Vulkan 1.3 features that we are going to use
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT enable_descriptor_buffer_features {
+            .sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+            .descriptorBuffer = VK_TRUE
+        };
+
+        VkPhysicalDeviceShaderObjectFeaturesEXT enable_shader_object_features {
+            .sType        = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+            .pNext        = _context->features.descriptor_buffer ? &enable_descriptor_buffer_features : nullptr,
+            .shaderObject = VK_TRUE
+        };
+
         VkPhysicalDeviceExtendedDynamicState3FeaturesEXT enable_extended_dynamic_state_3_features {
             .sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+            .pNext                            = _context->features.shader_object
+                ? static_cast<void*>(&enable_shader_object_features)
+                : _context->features.descriptor_buffer ? static_cast<void*>(&enable_descriptor_buffer_features) : nullptr,
             .extendedDynamicState3PolygonMode = VK_TRUE
         };
 
@@ -231,14 +323,33 @@ namespace fr {
             .dynamicRendering = VK_TRUE
         };
 
+        // Buffer device addresses let shaders read buffers through 64-bit pointers instead of descriptor bindings
+        VkPhysicalDeviceVulkan12Features enable_vulkan12_features {
+            .sType               = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+            .pNext               = &enable_vulkan13_features,
+            .bufferDeviceAddress = _context->features.buffer_device_address ? VK_TRUE : VK_FALSE
+        };
+
+        if (_context->features.descriptor_indexing) {
+            enable_vulkan12_features.descriptorIndexing                           = VK_TRUE;
+            enable_vulkan12_features.shaderSampledImageArrayNonUniformIndexing    = VK_TRUE;
+            enable_vulkan12_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            enable_vulkan12_features.descriptorBindingUpdateUnusedWhilePending    = VK_TRUE;
+            enable_vulkan12_features.descriptorBindingPartiallyBound              = VK_TRUE;
+            enable_vulkan12_features.descriptorBindingVariableDescriptorCount     = VK_TRUE;
+            enable_vulkan12_features.runtimeDescriptorArray                       = VK_TRUE;
+        }
+
         VkPhysicalDeviceFeatures enable_device_features {
             .fillModeNonSolid = VK_TRUE,
+            .samplerAnisotropy = _context->features.sampler_anisotropy ? VK_TRUE : VK_FALSE,
+            .shaderInt64 = _context->features.buffer_device_address ? VK_TRUE : VK_FALSE,
             .shaderResourceMinLod = VK_TRUE
         };
 
         VkPhysicalDeviceFeatures2 enable_device_features2 {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
-            .pNext = &enable_vulkan13_features,
+            .pNext = &enable_vulkan12_features,
             .features = enable_device_features
         };
 
@@ -271,6 +382,7 @@ namespace fr {
 
     void VulkanBuilder::_create_memory_allocator() {
         VmaAllocatorCreateInfo allocator_create_info {
+            .flags = _context->features.buffer_device_address ? VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT : VmaAllocatorCreateFlags {0},
             .physicalDevice = _context->gpu,
             .device = _context->device,
             .instance = _context->instance,
@@ -283,11 +395,91 @@ namespace fr {
         );
     }
 
+    void VulkanBuilder::_create_sampler_cache() {
+        VkPhysicalDeviceProperties device_properties;
+        vkGetPhysicalDeviceProperties(_context->gpu, &device_properties);
+
+        _context->sampler_cache = std::make_unique<SamplerCache>(
+            _context->device,
+            _context->features.sampler_anisotropy ? device_properties.limits.maxSamplerAnisotropy : 0.0f,
+            device_properties.limits.maxSamplerAllocationCount
+        );
+    }
+
+    void VulkanBuilder::_create_descriptor_allocators() {
+        _context->descriptor_layout_cache = std::make_unique<DescriptorLayoutCache>(_context->device);
+        _context->descriptor_allocator    = std::make_unique<DescriptorAllocator>(_context->device);
+    }
+
+    void VulkanBuilder::_create_pipeline_cache() {
+        _context->pipeline_cache = std::make_unique<PipelineCache>(_context->device, _context->gpu, PipelineCache::default_path());
+    }
+
     void VulkanBuilder::_load_device_extensions() {
         // Allows us to dynamically set the polygon mode during render time.
         _context->extensions.polygon_mode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
             vkGetDeviceProcAddr(_context->device, "vkCmdSetPolygonModeEXT")
         );
+
+        if (_context->features.push_descriptor) {
+            _context->extensions.push_descriptor_set = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdPushDescriptorSetKHR")
+            );
+            _context->extensions.push_descriptor_set_with_template = reinterpret_cast<PFN_vkCmdPushDescriptorSetWithTemplateKHR>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdPushDescriptorSetWithTemplateKHR")
+            );
+        }
+
+        if (_context->features.descriptor_buffer) {
+            _context->extensions.get_descriptor = reinterpret_cast<PFN_vkGetDescriptorEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkGetDescriptorEXT")
+            );
+            _context->extensions.get_descriptor_set_layout_size = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkGetDescriptorSetLayoutSizeEXT")
+            );
+            _context->extensions.get_descriptor_set_layout_binding_offset = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkGetDescriptorSetLayoutBindingOffsetEXT")
+            );
+            _context->extensions.bind_descriptor_buffers = reinterpret_cast<PFN_vkCmdBindDescriptorBuffersEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdBindDescriptorBuffersEXT")
+            );
+            _context->extensions.set_descriptor_buffer_offsets = reinterpret_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetDescriptorBufferOffsetsEXT")
+            );
+        }
+
+        if (_context->features.shader_object) {
+            _context->extensions.create_shaders = reinterpret_cast<PFN_vkCreateShadersEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCreateShadersEXT")
+            );
+            _context->extensions.destroy_shader = reinterpret_cast<PFN_vkDestroyShaderEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkDestroyShaderEXT")
+            );
+            _context->extensions.bind_shaders = reinterpret_cast<PFN_vkCmdBindShadersEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdBindShadersEXT")
+            );
+            _context->extensions.set_vertex_input = reinterpret_cast<PFN_vkCmdSetVertexInputEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetVertexInputEXT")
+            );
+            _context->extensions.set_rasterization_samples = reinterpret_cast<PFN_vkCmdSetRasterizationSamplesEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetRasterizationSamplesEXT")
+            );
+            _context->extensions.set_sample_mask = reinterpret_cast<PFN_vkCmdSetSampleMaskEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetSampleMaskEXT")
+            );
+            _context->extensions.set_alpha_to_coverage_enable = reinterpret_cast<PFN_vkCmdSetAlphaToCoverageEnableEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetAlphaToCoverageEnableEXT")
+            );
+            _context->extensions.set_color_blend_enable = reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetColorBlendEnableEXT")
+            );
+            _context->extensions.set_color_blend_equation = reinterpret_cast<PFN_vkCmdSetColorBlendEquationEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetColorBlendEquationEXT")
+            );
+            _context->extensions.set_color_write_mask = reinterpret_cast<PFN_vkCmdSetColorWriteMaskEXT>(
+                vkGetDeviceProcAddr(_context->device, "vkCmdSetColorWriteMaskEXT")
+            );
+        }
     }
 
     void VulkanBuilder::_init_per_frame(PerFrame& per_frame) {
@@ -320,6 +512,8 @@ namespace fr {
             vkAllocateCommandBuffers(_context->device, &cmd_buf_info, &per_frame.primary_command_buffer),
             "Failed to allocate command buffers."
         );
+
+        per_frame.descriptor_allocator = std::make_unique<DescriptorAllocator>(_context->device);
     }
 
     void VulkanBuilder::_create_swap_chain() {
@@ -0,0 +1,113 @@
+#include "vulkan_structures.h"
+#include "drawing/descriptor_allocator.h"
+
+void VkContext::teardown_per_frame(PerFrame& per_frame) {
+	if (per_frame.queue_submit_fence != VK_NULL_HANDLE) {
+		vkDestroyFence(device, per_frame.queue_submit_fence, nullptr);
+
+		per_frame.queue_submit_fence = VK_NULL_HANDLE;
+	}
+
+	if (per_frame.primary_command_buffer != VK_NULL_HANDLE) {
+		vkFreeCommandBuffers(device, per_frame.primary_command_pool, 1, &per_frame.primary_command_buffer);
+
+		per_frame.primary_command_buffer = VK_NULL_HANDLE;
+	}
+
+	if (per_frame.primary_command_pool != VK_NULL_HANDLE) {
+		vkDestroyCommandPool(device, per_frame.primary_command_pool, nullptr);
+
+		per_frame.primary_command_pool = VK_NULL_HANDLE;
+	}
+
+	if (per_frame.swap_chain_acquire_semaphore != VK_NULL_HANDLE) {
+		vkDestroySemaphore(device, per_frame.swap_chain_acquire_semaphore, nullptr);
+
+		per_frame.swap_chain_acquire_semaphore = VK_NULL_HANDLE;
+	}
+
+	if (per_frame.swap_chain_release_semaphore != VK_NULL_HANDLE) {
+		vkDestroySemaphore(device, per_frame.swap_chain_release_semaphore, nullptr);
+
+		per_frame.swap_chain_release_semaphore = VK_NULL_HANDLE;
+	}
+
+	per_frame.descriptor_allocator.reset();
+}
+
+VkContext::~VkContext() {
+	// Don't release anything until the GPU is completely idle
+	if (device != VK_NULL_HANDLE)
+		vkDeviceWaitIdle(device);
+
+	// Free device attachments
+	for (auto& semaphore : recycled_semaphores) {
+		vkDestroySemaphore(device, semaphore, nullptr);
+	}
+	recycled_semaphores.clear();
+
+	descriptor.destroy();
+	descriptor_allocator.reset();
+	sampler_cache.reset();
+
+	vertex_buffer.destroy();
+	indices_buffer.destroy();
+	instance_buffer.destroy();
+
+	if (pipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(device, pipeline, nullptr);
+		pipeline = VK_NULL_HANDLE;
+	}
+
+	if (pipeline_layout != VK_NULL_HANDLE) {
+		vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
+		pipeline_layout = VK_NULL_HANDLE;
+	}
+
+	// Written back to disk on destruction
+	pipeline_cache.reset();
+
+	for (auto& image_view : swap_chain_image_views) {
+		vkDestroyImageView(device, image_view, nullptr);
+	}
+
+	if (depth_image_view != VK_NULL_HANDLE) {
+		vkDestroyImageView(device, depth_image_view, nullptr);
+	}
+
+	if (depth_allocation != VK_NULL_HANDLE) {
+		vmaDestroyImage(allocator, depth_image, depth_allocation);
+	}
+
+	for (auto& per_frame : per_frame) {
+		teardown_per_frame(per_frame);
+	}
+	per_frame.clear();
+
+	descriptor_layout_cache.reset();
+
+	if (swap_chain != VK_NULL_HANDLE) {
+		vkDestroySwapchainKHR(device, swap_chain, nullptr);
+		swap_chain = VK_NULL_HANDLE;
+	}
+
+	if (allocator != VK_NULL_HANDLE) {
+		vmaDestroyAllocator(allocator);
+	}
+
+	if (device != VK_NULL_HANDLE) {
+		vkDestroyDevice(device, nullptr);
+		device = VK_NULL_HANDLE;
+	}
+
+	// Free instance attachments
+	if (surface != VK_NULL_HANDLE) {
+		vkDestroySurfaceKHR(instance, surface, nullptr);
+		surface = VK_NULL_HANDLE;
+	}
+
+	if (instance != VK_NULL_HANDLE) {
+		vkDestroyInstance(instance, nullptr);
+		instance = VK_NULL_HANDLE;
+	}
+}
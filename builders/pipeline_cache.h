@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <type_traits>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace fr {
+    /// Prefix written ahead of the driver's cache data. Vulkan's own header has no driver version or checksum.
+    struct PipelineCacheFileHeader {
+        static constexpr std::array<char, 4> expected_magic = {'F', 'R', 'P', 'C'};
+        static constexpr std::uint32_t current_version = 1;
+
+        std::array<char, 4> magic = expected_magic;
+        std::uint32_t version        = current_version;
+        std::uint32_t vendor_id      = 0;
+        std::uint32_t device_id      = 0;
+        std::uint32_t driver_version = 0;
+        std::array<std::uint8_t, VK_UUID_SIZE> cache_uuid {};
+        std::uint32_t reserved       = 0;  // Keeps data_size aligned without implicit padding
+        std::uint64_t data_size      = 0;
+        std::uint64_t data_hash      = 0;
+    };
+
+    // The header is written to disk byte for byte, so no byte may be uninitialised padding
+    static_assert(sizeof(PipelineCacheFileHeader) == 56);
+    static_assert(std::has_unique_object_representations_v<PipelineCacheFileHeader>);
+
+    /*
+     *  A VkPipelineCache persisted between runs.
+     *
+     *  The file is only used when it was written by the same vendor, device, driver version and pipelineCacheUUID and its
+     *      checksum matches, otherwise the cache starts empty. The cache is shared by every pipeline creation (Vulkan
+     *      synchronises access internally) and written back under a temporary name then renamed on destruction, so a
+     *      crash never leaves a truncated file behind.
+     */
+    class PipelineCache {
+    public:
+        PipelineCache(VkDevice device, VkPhysicalDevice gpu, std::filesystem::path path);
+
+        /// Saves the cache; failures are reported but not thrown
+        ~PipelineCache();
+
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        /// Inline: pipelines are created in drawing, which does not link builders
+        [[nodiscard]] VkPipelineCache get() const {
+            return _cache;
+        }
+
+        /// Writes the current contents to disk
+        void save() const;
+
+        /// True when the cache was seeded from a valid file
+        [[nodiscard]] bool was_loaded() const;
+
+        /// $XDG_CACHE_HOME/four_rendering/pipeline_cache.bin, falling back to ~/.cache and then the temp directory
+        [[nodiscard]] static std::filesystem::path default_path();
+
+    private:
+        VkDevice _device;
+        std::filesystem::path _path;
+        PipelineCacheFileHeader _expected_header {};
+        VkPipelineCache _cache = VK_NULL_HANDLE;
+        bool _loaded = false;
+
+        [[nodiscard]] std::vector<char> _read_valid_data() const;
+    };
+}  // namespace fr
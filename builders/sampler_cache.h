@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+namespace fr {
+    /// The full state of a sampler. Textures that share settings share one VkSampler through the SamplerCache.
+    struct SamplerSettings {
+        VkFilter             mag_filter     = VK_FILTER_LINEAR;
+        VkFilter             min_filter     = VK_FILTER_LINEAR;
+        VkSamplerMipmapMode  mipmap_mode    = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        VkSamplerAddressMode address_u      = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        VkSamplerAddressMode address_v      = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        VkSamplerAddressMode address_w      = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        VkBorderColor        border_color   = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+        float                mip_lod_bias   = 0.0f;
+        float                max_anisotropy = 0.0f;  // 0 or 1 disables anisotropic filtering; clamped to the device limit
+        bool                 compare_enable = false;
+        VkCompareOp          compare_op     = VK_COMPARE_OP_NEVER;
+        float                min_lod        = 0.0f;
+        float                max_lod        = VK_LOD_CLAMP_NONE;  // the image view already limits the mip range
+
+        bool operator==(const SamplerSettings& other) const = default;
+
+        /// Linear filtering with clamped addressing, for textures that sit edge to edge (e.g. terrain tiles)
+        static SamplerSettings clamped(float max_anisotropy = 0.0f);
+    };
+
+    struct SamplerSettingsHash {
+        std::size_t operator()(const SamplerSettings& settings) const;
+    };
+
+    /*
+     *  Creates each distinct sampler once and hands out the shared handle.
+     *
+     *  Devices cap the number of live samplers (maxSamplerAllocationCount, as low as 4000), so textures must not own
+     *      one each. Samplers live as long as the cache, which VkContext destroys before the device.
+     */
+    class SamplerCache {
+    public:
+        /// max_anisotropy is the device limit, or 0 when samplerAnisotropy is not enabled
+        SamplerCache(VkDevice device, float max_anisotropy, std::uint32_t max_samplers);
+
+        ~SamplerCache();
+
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+        /// Returns the sampler for the settings, creating it on first use. Thread safe.
+        VkSampler get(const SamplerSettings& settings);
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        VkDevice _device;
+        float _max_anisotropy;
+        std::uint32_t _max_samplers;
+        mutable std::mutex _mutex;
+        std::unordered_map<SamplerSettings, VkSampler, SamplerSettingsHash> _samplers;
+
+        [[nodiscard]] VkSampler _create_sampler(const SamplerSettings& settings) const;
+    };
+}  // namespace fr
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "texture_loader.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace fr {
+    /*
+     *  Packs equally sized RGBA8 colour maps into the layers of one VK_IMAGE_VIEW_TYPE_2D_ARRAY image.
+     *
+     *  Each Grid2D instance selects its layer through InstanceData::texture_layer, so every tile is drawn with the
+     *      same descriptor set while its imagery can be streamed in, or replaced, one layer at a time.
+     */
+    class TextureArray {
+    public:
+        TextureArray(const std::shared_ptr<VkContext>& context, std::uint32_t width, std::uint32_t height, std::uint32_t layer_count);
+
+        ~TextureArray();
+
+        TextureArray(const TextureArray&) = delete;
+        TextureArray& operator=(const TextureArray&) = delete;
+
+        /// Reserves a free layer and returns its index. Throws when every layer is in use.
+        std::uint32_t allocate_layer();
+
+        /// Returns a layer to the free list; its contents stay valid until the layer is uploaded to again
+        void release_layer(std::uint32_t layer);
+
+        /// Decodes an image into a layer, replacing its previous contents. The image must match the array size.
+        void upload_layer(std::uint32_t layer, const std::filesystem::path& path);
+
+        /// Uploads width * height RGBA8 texels into a layer, replacing its previous contents
+        void upload_layer(std::uint32_t layer, const std::uint8_t* data);
+
+        TextureInfo get_info();
+
+        [[nodiscard]] std::uint32_t get_layer_count() const;
+
+        [[nodiscard]] std::uint32_t get_free_layer_count() const;
+
+    private:
+        std::shared_ptr<VkContext> _context;
+        VmaAllocation _allocation = VK_NULL_HANDLE;
+        std::uint32_t _width = 0;
+        std::uint32_t _height = 0;
+        std::uint32_t _layer_count = 0;
+        std::uint32_t _mip_levels = 1;
+        VkFormat      _format = VK_FORMAT_R8G8B8A8_SRGB;
+        bool          _blit_mipmaps = false;
+        std::vector<std::uint32_t> _free_layers;
+        std::vector<bool> _allocated;
+        TextureInfo   _info {};
+
+        void _create_image();
+
+        void _create_view();
+
+        void _create_sampler();
+
+        void _initialize_layers();
+
+        void _validate_layer(std::uint32_t layer) const;
+    };
+}  // namespace fr
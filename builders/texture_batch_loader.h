@@ -0,0 +1,36 @@
+#pragma once
+
+#include "texture_loader.h"
+#include "utils/thread_pool.h"
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace fr {
+    /*
+     *  Loads many textures at once.
+     *
+     *  Images are decoded concurrently on a worker pool, and each worker writes its image into its own staging
+     *      buffer as soon as it is decoded. The calling thread picks up textures in the order they finish, and
+     *      records their uploads into a shared command buffer which is submitted every batch_size textures.
+     */
+    class TextureBatchLoader {
+    public:
+        explicit TextureBatchLoader(
+            const std::shared_ptr<VkContext>& context,
+            std::shared_ptr<TextureDiskCache> disk_cache = nullptr,
+            std::size_t n_threads = std::thread::hardware_concurrency()
+        );
+
+        /// Returns the textures in the same order as the input paths
+        std::vector<std::unique_ptr<Texture>> load(const std::vector<std::filesystem::path>& paths, std::size_t batch_size = 8);
+
+    private:
+        std::shared_ptr<VkContext> _context;
+        std::shared_ptr<TextureDiskCache> _disk_cache;
+        ThreadPool _pool;
+
+        void _submit_batch(std::vector<Texture*>& batch);
+    };
+}  // namespace fr
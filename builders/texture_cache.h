@@ -0,0 +1,115 @@
+#pragma once
+
+#include "texture_loader.h"
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fr {
+    /*
+     *  Shares textures between everything that requests the same image.
+     *
+     *  Textures are keyed by their canonical path (and optionally by a hash of the file contents, so copies of a tile
+     *      under different names are only loaded once). Files are only re-read when their modification time or size
+     *      changes: a path whose file changed is reloaded, unless its contents hash the same.
+     *
+     *  Handles are reference counted shared pointers; once only the cache holds a texture it becomes a candidate for
+     *      eviction. When the resident size exceeds the budget the least recently used candidates are evicted. Evicted
+     *      textures are destroyed after every in-flight frame has completed (see end_frame()), so eviction never stalls
+     *      the device.
+     */
+    class TextureCache {
+    public:
+        TextureCache(
+            const std::shared_ptr<VkContext>& context,
+            VkDeviceSize budget,
+            bool hash_contents = false,
+            std::shared_ptr<TextureDiskCache> disk_cache = nullptr
+        );
+
+        ~TextureCache();
+
+        /// Returns the cached texture for the path, loading it on a miss
+        std::shared_ptr<Texture> acquire(const std::filesystem::path& path);
+
+        /// Acquires many textures, decoding the misses concurrently (see TextureBatchLoader)
+        std::vector<std::shared_ptr<Texture>> acquire(const std::vector<std::filesystem::path>& paths);
+
+        void set_budget(VkDeviceSize budget);
+
+        /// Call once per presented frame: destroys evicted textures that no in-flight frame can still reference
+        void end_frame();
+
+        [[nodiscard]] VkDeviceSize resident_size() const;
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        struct FileStamp {
+            std::filesystem::file_time_type mtime;
+            std::uintmax_t size = 0;
+
+            bool operator==(const FileStamp&) const = default;
+        };
+
+        struct Entry {
+            std::shared_ptr<Texture> texture;
+            std::uint64_t content_hash = 0;
+            FileStamp stamp;
+            VkDeviceSize size = 0;
+            std::list<std::string>::iterator lru;  // Position in _lru, front is the most recently used
+        };
+
+        /// Another path whose contents matched an entry's when last hashed
+        struct Alias {
+            std::string key;
+            std::uint64_t content_hash = 0;
+            FileStamp stamp;
+        };
+
+        struct Lookup {
+            std::shared_ptr<Texture> texture;  // nullptr on a miss
+            std::uint64_t content_hash = 0;    // Only set on a miss, when hashing contents
+            FileStamp stamp;
+        };
+
+        struct Retired {
+            std::shared_ptr<Texture> texture;
+            std::uint64_t frame;
+        };
+
+        std::shared_ptr<VkContext> _context;
+        std::shared_ptr<TextureDiskCache> _disk_cache;
+        VkDeviceSize _budget;
+        bool _hash_contents;
+
+        std::unordered_map<std::string, Entry> _entries;
+        std::unordered_map<std::uint64_t, std::string> _keys_by_hash;
+        std::unordered_map<std::string, Alias> _aliases;
+        std::list<std::string> _lru;
+        std::deque<Retired> _retired;
+        VkDeviceSize _resident_size = 0;
+        std::uint64_t _frame = 0;
+
+        static std::string _make_key(const std::filesystem::path& path);
+
+        static FileStamp _make_stamp(const std::filesystem::path& path);
+
+        /// Looks up an entry by key, or by content hash for paths not seen before, marking it as most recently used.
+        ///     An entry whose file changed is removed so that the caller reloads it.
+        Lookup _find(const std::filesystem::path& path, const std::string& key);
+
+        void _insert(const std::string& key, const Lookup& lookup, std::shared_ptr<Texture> texture);
+
+        /// Drops an entry from the cache. Its texture is destroyed once no frame or handle can still use it.
+        void _remove(std::unordered_map<std::string, Entry>::iterator entry);
+
+        void _evict();
+    };
+}  // namespace fr
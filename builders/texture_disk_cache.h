@@ -0,0 +1,88 @@
+#pragma once
+
+#include "utils/mapped_file.h"
+#include "utils/thread_pool.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+/*
+ *  Stores decoded texel data on disk so images are only decoded on the first run.
+ *
+ *  Each entry is a DiskCacheHeader followed by the payload: every mip level tightly packed, largest first, which is
+ *      exactly the layout Texture uploads from its staging buffer. Entries are memory mapped on lookup and copied
+ *      straight into staging memory. An entry is stale when the source file's modification time or size changed,
+ *      or (when content validation is enabled) when the hash of its contents changed. Entries whose header does not
+ *      describe a full RGBA8 mip chain of exactly the stored payload are ignored.
+ */
+
+namespace fr {
+    struct DiskCacheHeader {
+        static constexpr std::array<char, 4> expected_magic = {'F', 'R', 'T', 'C'};
+        static constexpr std::uint32_t current_version = 1;
+
+        std::array<char, 4> magic = expected_magic;
+        std::uint32_t version      = current_version;
+        std::int64_t  source_mtime = 0;
+        std::uint64_t source_size  = 0;
+        std::uint64_t source_hash  = 0;  // 0 unless content validation is enabled
+        std::uint32_t format       = VK_FORMAT_UNDEFINED;
+        std::uint32_t width        = 0;
+        std::uint32_t height       = 0;
+        std::uint32_t mip_levels   = 0;
+        std::uint64_t payload_size = 0;
+    };
+
+    struct CachedTexture {
+        DiskCacheHeader header;
+        file_system::MappedFile file;
+
+        [[nodiscard]] const std::byte* payload() const {
+            return file.data() + sizeof(DiskCacheHeader);
+        }
+    };
+
+    class TextureDiskCache {
+    public:
+        explicit TextureDiskCache(std::filesystem::path directory, bool validate_contents = false);
+
+        /// Maps the cache entry for a source image, if one exists and is still valid
+        [[nodiscard]] std::optional<CachedTexture> find(const std::filesystem::path& source) const;
+
+        /// Writes (or replaces) the entry for a source image. The file is written under a temporary name and renamed,
+        /// so concurrent readers never see a partial entry.
+        void store(
+            const std::filesystem::path& source,
+            VkFormat format,
+            std::uint32_t width,
+            std::uint32_t height,
+            const std::vector<std::span<const std::uint8_t>>& mip_levels
+        ) const;
+
+        /// Filters the mip chain of an RGBA8 base level and stores it on a background thread, off the load path.
+        /// The write is best-effort: a failure is logged and the entry is simply left out.
+        void store_async(
+            const std::filesystem::path& source,
+            VkFormat format,
+            std::uint32_t width,
+            std::uint32_t height,
+            std::vector<std::uint8_t> base
+        );
+
+    private:
+        std::filesystem::path _directory;
+        bool _validate_contents;
+        ThreadPool _writer {1};  // Declared last: pending writes are drained before the other members go away
+
+        [[nodiscard]] std::filesystem::path _entry_path(const std::filesystem::path& source) const;
+
+        /// Header with the source fields filled in for the current state of the source file
+        [[nodiscard]] DiskCacheHeader _describe_source(const std::filesystem::path& source) const;
+    };
+}  // namespace fr
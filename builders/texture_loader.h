@@ -1,6 +1,8 @@
 #pragma once
 
 #include "vulkan_structures.h"
+#include "compressed_texture.h"
+#include "texture_disk_cache.h"
 
 #include <filesystem>
 
@@ -15,26 +17,76 @@ namespace fr {
 
     class Texture {
     public:
-        Texture(const std::shared_ptr<VkContext>& context);
+        /// With a disk cache, decoded images (and their mips) are written on first load and read back on later runs
+        Texture(const std::shared_ptr<VkContext>& context, std::shared_ptr<TextureDiskCache> disk_cache = nullptr);
 
         ~Texture();
 
+        /// Loads an image through stb, or uploads the blocks of a KTX2/DDS container directly
         void load(const std::filesystem::path& path);
 
+        /*
+         *  The load is split into three steps so that many textures can be loaded together (see TextureBatchLoader):
+         *      prepare:       decodes the file and fills the staging buffer. Safe to call from worker threads.
+         *      record_upload: records the staging copies (and mip generation) into a command buffer.
+         *      finish_upload: creates the sampler and view once the command buffer has completed.
+         */
+        void prepare(const std::filesystem::path& path);
+
+        void record_upload(VkCommandBuffer cmd);
+
+        void finish_upload();
+
         TextureInfo get_info();
 
+        /// Selects the texture's sampler from the shared sampler cache. Defaults to linear filtering with repeat addressing.
+        void set_sampler(const SamplerSettings& settings);
+
+        /// Device memory used by the image (all mip levels)
+        [[nodiscard]] VkDeviceSize get_memory_size() const;
+
+        /// Marks the texture as unused by any in-flight frame, so destroying it does not wait for the device to idle
+        void retire();
+
     private:
         std::shared_ptr<VkContext> _context;
-        void*         _data;
+        std::shared_ptr<TextureDiskCache> _disk_cache;
+        std::filesystem::path _path;
+        void*         _data = nullptr;
+        std::uint32_t _channels = 4;  // Channels of _data as decoded, expanded to RGBA when staged
         VkImageLayout _image_layout;
-        VmaAllocation _allocation;
-        uint32_t      _mip_levels;
+        VmaAllocation _allocation = VK_NULL_HANDLE;
+        VkDeviceSize  _memory_size = 0;
+        bool          _retired = false;
+        std::uint32_t _width = 0;
+        std::uint32_t _height = 0;
+        VkFormat      _format = VK_FORMAT_R8G8B8A8_SRGB;
+        uint32_t      _mip_levels = 1;
+        bool          _blit_mipmaps = false;  // Generate mips on the GPU, otherwise they are filtered on the CPU into staging
         BufferCore    _staging_buffer;
-        TextureInfo   _info;
+        std::vector<VkBufferImageCopy> _copy_regions;
+        TextureInfo   _info {};
+        SamplerSettings _sampler_settings {};
+
+        void _prepare_compressed(const std::filesystem::path& path);
+
+        void _create_image(std::uint32_t width, std::uint32_t height, VkImageUsageFlags usage);
 
         void _prepare_resources(std::uint32_t width, std::uint32_t height);
 
-        void _copy_data(std::uint32_t width, std::uint32_t height);
+        void _prepare_compressed_resources(const CompressedImage& compressed);
+
+        void _prepare_cached(const CachedTexture& cached);
+
+        void _add_mip_chain_regions(std::uint32_t width, std::uint32_t height, std::uint32_t levels);
+
+        void _add_copy_region(VkDeviceSize offset, std::uint32_t mip_level, std::uint32_t width, std::uint32_t height);
+
+        [[nodiscard]] bool _supports_blit(VkFormat format) const;
+
+        [[nodiscard]] bool _supports_sampling(VkFormat format) const;
+
+        void _fill_staging_mip_chain(const std::uint8_t* base, std::uint32_t width, std::uint32_t height);
 
         void _create_sampler();
 
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "texture_loader.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace fr {
+    class TextureStreamer;
+
+    /*
+     *  A texture whose mip chain is made resident coarsest level first.
+     *
+     *  The view and sampler cover the whole chain and never change, so descriptors are written once. Levels finer than
+     *      get_min_lod() hold undefined texels: the texture must be drawn through a BindlessTextureTable slot whose min
+     *      LOD follows it, so it can be drawn as soon as its mip tail has been uploaded and sharpens as it is refined.
+     */
+    class StreamedTexture {
+    public:
+        ~StreamedTexture();
+
+        StreamedTexture(const StreamedTexture&) = delete;
+        StreamedTexture& operator=(const StreamedTexture&) = delete;
+
+        TextureInfo get_info();
+
+        /// Finest mip level that may be sampled
+        [[nodiscard]] std::uint32_t get_resident_level() const;
+
+        /// The resident level as a shader LOD clamp (see BindlessTextureTable::set_min_lod)
+        [[nodiscard]] float get_min_lod() const;
+
+        [[nodiscard]] bool is_complete() const;
+
+    private:
+        friend class TextureStreamer;
+
+        explicit StreamedTexture(const std::shared_ptr<VkContext>& context);
+
+        std::shared_ptr<VkContext> _context;
+        VmaAllocation _allocation = VK_NULL_HANDLE;
+        VkFormat      _format = VK_FORMAT_R8G8B8A8_SRGB;
+        std::uint32_t _width = 0;
+        std::uint32_t _height = 0;
+        std::uint32_t _mip_levels = 1;
+        std::uint32_t _resident_level = 0;
+        std::uint32_t _next_level = 0;      // Level whose rows are being recorded
+        std::uint32_t _recorded_rows = 0;   // Rows of _next_level recorded so far
+        bool          _recorded_all = true; // Every level has been recorded, only fences are outstanding
+        TextureInfo   _info {};
+
+        // Host copy of the full chain, released once every level is resident
+        std::vector<std::uint8_t> _base;
+        std::vector<std::uint8_t> _chain;
+        std::vector<std::span<const std::uint8_t>> _levels;
+
+        [[nodiscard]] std::uint32_t _level_width(std::uint32_t level) const;
+
+        [[nodiscard]] std::uint32_t _level_height(std::uint32_t level) const;
+
+        void _make_resident(std::uint32_t level);
+    };
+
+    /*
+     *  Streams textures progressively under a per-frame upload budget.
+     *
+     *  load() decodes an image, uploads only the levels no larger than tail_size and returns immediately. update() is
+     *      called once per frame: it uploads row bands of the next finer level of the blurriest textures until the frame
+     *      budget is spent, on its own command buffers submitted ahead of the frame's draw.
+     *  Uploads use frames-in-flight command buffers, so a level only becomes resident once its fence has signalled.
+     */
+    class TextureStreamer {
+    public:
+        TextureStreamer(const std::shared_ptr<VkContext>& context, VkDeviceSize frame_budget, std::uint32_t tail_size = 64);
+
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+        /// Decodes the image and makes its mip tail resident. The texture can be drawn as soon as this returns, from a
+        ///     bindless slot added with get_min_lod().
+        std::shared_ptr<StreamedTexture> load(const std::filesystem::path& path, const SamplerSettings& sampler_settings = {});
+
+        /// Records and submits this frame's uploads. Returns the textures that gained a level: their bindless slots'
+        ///     min LOD must be lowered to get_min_lod(). Textures only the streamer still references are dropped.
+        std::vector<std::shared_ptr<StreamedTexture>> update();
+
+        void set_frame_budget(VkDeviceSize frame_budget);
+
+        /// Number of textures that still have levels to stream
+        [[nodiscard]] std::size_t pending() const;
+
+    private:
+        struct CompletedLevel {
+            std::shared_ptr<StreamedTexture> texture;
+            std::uint32_t level;
+        };
+
+        struct UploadFrame {
+            VkCommandPool   command_pool = VK_NULL_HANDLE;
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+            VkFence         fence = VK_NULL_HANDLE;
+            std::unique_ptr<BufferCore> staging;
+            std::vector<CompletedLevel> completed;
+            bool            submitted = false;
+        };
+
+        struct UploadBand {
+            StreamedTexture* texture;
+            std::uint32_t level;
+            std::uint32_t first_row;
+            std::uint32_t rows;
+            VkDeviceSize  staging_offset;
+        };
+
+        std::shared_ptr<VkContext> _context;
+        VkDeviceSize _frame_budget;
+        std::uint32_t _tail_size;
+        std::uint64_t _frame = 0;
+        std::vector<UploadFrame> _frames;
+        std::vector<std::shared_ptr<StreamedTexture>> _streaming;
+
+        void _create_frames();
+
+        [[nodiscard]] std::vector<UploadBand> _plan_bands();
+
+        void _record_bands(UploadFrame& frame, const std::vector<UploadBand>& bands);
+    };
+}  // namespace fr
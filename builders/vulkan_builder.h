@@ -35,6 +35,8 @@ namespace fr {
             const std::vector<VkExtensionProperties>& available
         );
 
+        static bool _has_extension(const char* name, const std::vector<VkExtensionProperties>& available);
+
         static std::vector<const char*> _get_requested_layers();
 
         static std::vector<const char*> _get_required_extensions();
@@ -49,6 +51,12 @@ namespace fr {
 
         void _create_memory_allocator();
 
+        void _create_sampler_cache();
+
+        void _create_descriptor_allocators();
+
+        void _create_pipeline_cache();
+
         void _load_device_extensions();
 
         void _init_per_frame(PerFrame& per_frame);
@@ -2,17 +2,26 @@
 
 #include "window/GLFW_window.h"
 #include "camera/camera.h"
+#include "sampler_cache.h"
+#include "pipeline_cache.h"
 
 #include <vector>
 #include <memory>
 
 #include "vk_mem_alloc.h"
 
+// Descriptor set allocation lives in drawing/descriptor_allocator.h
+namespace fr {
+	class DescriptorAllocator;
+	class DescriptorLayoutCache;
+}
+
 struct BufferCore {
 	VkDevice* device              = VK_NULL_HANDLE;
 	VmaAllocator* allocator       = VK_NULL_HANDLE;
 	VmaAllocation allocation      = VK_NULL_HANDLE;
 	VkBuffer  buffer              = VK_NULL_HANDLE;
+	VkDeviceAddress address       = 0;  // Only set for buffers created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
 	std::uint32_t count           = 0;
 	std::size_t size              = 0;
 	std::size_t n_buffers         = 0;
@@ -30,15 +39,14 @@ struct BufferCore {
 		if (buffer != VK_NULL_HANDLE) {
 			vmaDestroyBuffer(*allocator, buffer, allocation);
 			buffer = VK_NULL_HANDLE;
+			address = 0;
 		}
 	}
 };
 
 struct DescriptorCore {
 	VkDevice* device                            = VK_NULL_HANDLE;
-	VkDescriptorPool pool                       = VK_NULL_HANDLE;
-	std::uint32_t pool_size                     =  0;
-	VkDescriptorSetLayout layout                = VK_NULL_HANDLE;
+	VkDescriptorSetLayout layout                = VK_NULL_HANDLE;  // Owned by VkContext::descriptor_layout_cache
 	VkDescriptorSet descriptor                  = VK_NULL_HANDLE;
 	VmaAllocator* allocator						= VK_NULL_HANDLE;
 	BufferCore uniform_buffer                   ;
@@ -58,15 +66,9 @@ struct DescriptorCore {
 	}
 
 	void destroy() {
-		if (layout != VK_NULL_HANDLE) {
-			vkDestroyDescriptorSetLayout(*device, layout, nullptr);
-			layout = VK_NULL_HANDLE;
-		}
-
-		if (pool != VK_NULL_HANDLE) {
-			vkDestroyDescriptorPool(*device, pool, nullptr);
-			pool = VK_NULL_HANDLE;
-		}
+		// The set goes back with its allocator's pools
+		layout = VK_NULL_HANDLE;
+		descriptor = VK_NULL_HANDLE;
 
 		uniform_buffer.destroy();
 		storage_buffer.destroy();
@@ -92,6 +94,50 @@ struct SurfaceProperties {
 
 struct Extensions {
 	PFN_vkCmdSetPolygonModeEXT polygon_mode = VK_NULL_HANDLE;
+
+	/// Only loaded when Features::push_descriptor is set
+	PFN_vkCmdPushDescriptorSetKHR push_descriptor_set = VK_NULL_HANDLE;
+	PFN_vkCmdPushDescriptorSetWithTemplateKHR push_descriptor_set_with_template = VK_NULL_HANDLE;
+
+	/// Only loaded when Features::descriptor_buffer is set
+	PFN_vkGetDescriptorEXT get_descriptor = VK_NULL_HANDLE;
+	PFN_vkGetDescriptorSetLayoutSizeEXT get_descriptor_set_layout_size = VK_NULL_HANDLE;
+	PFN_vkGetDescriptorSetLayoutBindingOffsetEXT get_descriptor_set_layout_binding_offset = VK_NULL_HANDLE;
+	PFN_vkCmdBindDescriptorBuffersEXT bind_descriptor_buffers = VK_NULL_HANDLE;
+	PFN_vkCmdSetDescriptorBufferOffsetsEXT set_descriptor_buffer_offsets = VK_NULL_HANDLE;
+
+	/// Only loaded when Features::shader_object is set
+	PFN_vkCreateShadersEXT create_shaders = VK_NULL_HANDLE;
+	PFN_vkDestroyShaderEXT destroy_shader = VK_NULL_HANDLE;
+	PFN_vkCmdBindShadersEXT bind_shaders = VK_NULL_HANDLE;
+	PFN_vkCmdSetVertexInputEXT set_vertex_input = VK_NULL_HANDLE;
+	PFN_vkCmdSetRasterizationSamplesEXT set_rasterization_samples = VK_NULL_HANDLE;
+	PFN_vkCmdSetSampleMaskEXT set_sample_mask = VK_NULL_HANDLE;
+	PFN_vkCmdSetAlphaToCoverageEnableEXT set_alpha_to_coverage_enable = VK_NULL_HANDLE;
+	PFN_vkCmdSetColorBlendEnableEXT set_color_blend_enable = VK_NULL_HANDLE;
+	PFN_vkCmdSetColorBlendEquationEXT set_color_blend_equation = VK_NULL_HANDLE;
+	PFN_vkCmdSetColorWriteMaskEXT set_color_write_mask = VK_NULL_HANDLE;
+};
+
+/// Optional device features, enabled at device creation when the physical device supports them
+struct Features {
+	/// Descriptor indexing: partially bound, update-after-bind, variable count arrays (see BindlessTextureTable)
+	bool descriptor_indexing = false;
+
+	/// Anisotropic filtering in samplers (see SamplerSettings::max_anisotropy)
+	bool sampler_anisotropy = false;
+
+	/// bufferDeviceAddress and shaderInt64: shaders read buffers through 64-bit pointers (see BufferUtils::create_addressable_buffer)
+	bool buffer_device_address = false;
+
+	/// VK_KHR_push_descriptor: per-draw bindings recorded straight into the command buffer (see Renderer::push_descriptors)
+	bool push_descriptor = false;
+
+	/// VK_EXT_descriptor_buffer: descriptors written into plain buffer memory (see DescriptorBuffer)
+	bool descriptor_buffer = false;
+
+	/// VK_EXT_shader_object, natively or through the Khronos emulation layer: shaders bound without pipelines (see ShaderObjectProgram)
+	bool shader_object = false;
 };
 
 struct PerFrame {
@@ -100,12 +146,18 @@ struct PerFrame {
 	VkCommandBuffer primary_command_buffer       = VK_NULL_HANDLE;
 	VkSemaphore     swap_chain_acquire_semaphore = VK_NULL_HANDLE;
 	VkSemaphore     swap_chain_release_semaphore = VK_NULL_HANDLE;
+
+	/// Sets that only live for one frame, reset once queue_submit_fence has signalled
+	std::unique_ptr<fr::DescriptorAllocator> descriptor_allocator;
 };
 
 struct VkContext {
 	/// The additional vulkan extensions required by the renderer
 	Extensions extensions = {};
 
+	/// The optional features enabled on the device
+	Features features = {};
+
 	/// The GLFW application window
 	std::shared_ptr<fr::GLFWWindow> window = VK_NULL_HANDLE;
 
@@ -166,6 +218,18 @@ struct VkContext {
     /// A set of per-frame data.
     std::vector<PerFrame> per_frame;
 
+	/// Samplers shared by every texture
+	std::unique_ptr<fr::SamplerCache> sampler_cache;
+
+	/// Descriptor set layouts shared by every pipeline and set
+	std::unique_ptr<fr::DescriptorLayoutCache> descriptor_layout_cache;
+
+	/// Long lived descriptor sets
+	std::unique_ptr<fr::DescriptorAllocator> descriptor_allocator;
+
+	/// Shared by every pipeline creation, persisted between runs
+	std::unique_ptr<fr::PipelineCache> pipeline_cache;
+
 	/// The descriptor object that holds the Model/View/Projection data.
 	DescriptorCore descriptor = DescriptorCore(&device, &allocator);
 
@@ -179,106 +243,8 @@ struct VkContext {
 	BufferCore instance_buffer = BufferCore(&device, &allocator);
 	std::uint32_t instance_count = 1;
 
+	/// Defined out of line, the descriptor allocators are only forward declared here
+	void teardown_per_frame(PerFrame& per_frame);
 
-	void teardown_per_frame(PerFrame& per_frame) {
-		if (per_frame.queue_submit_fence != VK_NULL_HANDLE) {
-			vkDestroyFence(device, per_frame.queue_submit_fence, nullptr);
-
-			per_frame.queue_submit_fence = VK_NULL_HANDLE;
-		}
-
-		if (per_frame.primary_command_buffer != VK_NULL_HANDLE) {
-			vkFreeCommandBuffers(device, per_frame.primary_command_pool, 1, &per_frame.primary_command_buffer);
-
-			per_frame.primary_command_buffer = VK_NULL_HANDLE;
-		}
-
-		if (per_frame.primary_command_pool != VK_NULL_HANDLE) {
-			vkDestroyCommandPool(device, per_frame.primary_command_pool, nullptr);
-
-			per_frame.primary_command_pool = VK_NULL_HANDLE;
-		}
-
-		if (per_frame.swap_chain_acquire_semaphore != VK_NULL_HANDLE) {
-			vkDestroySemaphore(device, per_frame.swap_chain_acquire_semaphore, nullptr);
-
-			per_frame.swap_chain_acquire_semaphore = VK_NULL_HANDLE;
-		}
-
-		if (per_frame.swap_chain_release_semaphore != VK_NULL_HANDLE) {
-			vkDestroySemaphore(device, per_frame.swap_chain_release_semaphore, nullptr);
-
-			per_frame.swap_chain_release_semaphore = VK_NULL_HANDLE;
-		}
-	}
-
-	~VkContext() {
-		// Don't release anything until the GPU is completely idle
-		if (device != VK_NULL_HANDLE)
-			vkDeviceWaitIdle(device);
-
-		// Free device attachments
-		for (auto& semaphore : recycled_semaphores) {
-			vkDestroySemaphore(device, semaphore, nullptr);
-		}
-		recycled_semaphores.clear();
-
-		descriptor.destroy();
-
-		vertex_buffer.destroy();
-		indices_buffer.destroy();
-		instance_buffer.destroy();
-
-		if (pipeline != VK_NULL_HANDLE) {
-			vkDestroyPipeline(device, pipeline, nullptr);
-			pipeline = VK_NULL_HANDLE;
-		}
-
-		if (pipeline_layout != VK_NULL_HANDLE) {
-			vkDestroyPipelineLayout(device, pipeline_layout, nullptr);
-			pipeline_layout = VK_NULL_HANDLE;
-		}
-
-		for (auto& image_view : swap_chain_image_views) {
-			vkDestroyImageView(device, image_view, nullptr);
-		}
-
-		if (depth_image_view != VK_NULL_HANDLE) {
-			vkDestroyImageView(device, depth_image_view, nullptr);
-		}
-
-		if (depth_allocation != VK_NULL_HANDLE) {
-			vmaDestroyImage(allocator, depth_image, depth_allocation);
-		}
-
-		for (auto& per_frame : per_frame) {
-			teardown_per_frame(per_frame);
-		}
-		per_frame.clear();
-
-		if (swap_chain != VK_NULL_HANDLE) {
-			vkDestroySwapchainKHR(device, swap_chain, nullptr);
-			swap_chain = VK_NULL_HANDLE;
-		}
-
-		if (allocator != VK_NULL_HANDLE) {
-			vmaDestroyAllocator(allocator);
-		}
-
-		if (device != VK_NULL_HANDLE) {
-			vkDestroyDevice(device, nullptr);
-			device = VK_NULL_HANDLE;
-		}
-
-		// Free instance attachments
-		if (surface != VK_NULL_HANDLE) {
-			vkDestroySurfaceKHR(instance, surface, nullptr);
-			surface = VK_NULL_HANDLE;
-		}
-
-		if (instance != VK_NULL_HANDLE) {
-			vkDestroyInstance(instance, nullptr);
-			instance = VK_NULL_HANDLE;
-		}
-	}
+	~VkContext();
 };
\ No newline at end of file
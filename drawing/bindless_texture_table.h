@@ -0,0 +1,94 @@
+#pragma once
+
+#include "builders/vulkan_structures.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace fr {
+    /*
+     *  A global, partially bound array of combined image samplers that shaders index by material / tile id.
+     *
+     *  The table owns its own set layout, pool and set. Bind it once at set 1 (see RendererParams::bindless_descriptor),
+     *      and declare it in Slang as:
+     *          [[vk::binding(0, 1)]] StructuredBuffer<float> min_lods;
+     *          [[vk::binding(1, 1)]] Sampler2D textures[];
+     *          let texture = textures[NonUniformResourceIndex(id)];
+     *          texture.SampleLevel(uv, max(texture.CalculateLevelOfDetail(uv), min_lods[id]));
+     *
+     *  Slots are written with update-after-bind, so textures can be added while earlier frames are still in flight.
+     *      Removed slots are only handed out again after end_frame() has been called once per frame in flight.
+     *  Each slot also has a minimum LOD that shaders clamp to. It lets a texture whose finer levels are still being
+     *      streamed in (see StreamedTexture) sharpen without its descriptor ever being rewritten.
+     *  Requires VkContext::features.descriptor_indexing.
+     */
+    class BindlessTextureTable {
+    public:
+        static constexpr std::uint32_t min_lod_binding = 0;
+        static constexpr std::uint32_t binding = 1;  // The variable sized array must be the last binding
+
+        /// capacity is clamped to the device's update-after-bind sampled image limits
+        BindlessTextureTable(const std::shared_ptr<VkContext>& context, std::uint32_t capacity);
+
+        ~BindlessTextureTable();
+
+        BindlessTextureTable(const BindlessTextureTable&) = delete;
+        BindlessTextureTable& operator=(const BindlessTextureTable&) = delete;
+
+        /// Writes a texture into a free slot and returns its index. Throws when the table is full.
+        std::uint32_t add(const VkDescriptorImageInfo& image_info, float min_lod = 0.0f);
+
+        /// Points an existing slot at another texture (e.g. when a tile's imagery is refined)
+        void update(std::uint32_t index, const VkDescriptorImageInfo& image_info);
+
+        /// Sets the finest mip level shaders sample from the slot. Frames in flight may read either value, so it must
+        ///     only move to levels that are already resident.
+        void set_min_lod(std::uint32_t index, float min_lod);
+
+        /// Frees a slot. Shaders must no longer index it from frames recorded after this call.
+        void remove(std::uint32_t index);
+
+        /// Advances the frame counter, recycling slots removed per_frame.size() frames ago
+        void end_frame();
+
+        [[nodiscard]] VkDescriptorSetLayout get_layout() const;
+
+        [[nodiscard]] VkDescriptorSet get_descriptor_set() const;
+
+        [[nodiscard]] std::uint32_t get_capacity() const;
+
+        [[nodiscard]] std::uint32_t size() const;
+
+    private:
+        struct RetiredSlot {
+            std::uint32_t index;
+            std::uint64_t frame;
+        };
+
+        std::shared_ptr<VkContext> _context;
+        VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+        VkDescriptorPool _pool = VK_NULL_HANDLE;
+        VkDescriptorSet _descriptor = VK_NULL_HANDLE;
+        BufferCore _min_lods;  // One float per slot, read by shaders through min_lod_binding
+        std::uint32_t _capacity = 0;
+        std::uint32_t _used = 0;
+        std::uint64_t _frame = 0;
+        std::vector<std::uint32_t> _free_slots;
+        std::vector<RetiredSlot> _retired_slots;
+        std::vector<bool> _allocated;
+
+        [[nodiscard]] std::uint32_t _query_max_descriptors() const;
+
+        void _create_layout();
+
+        void _create_pool();
+
+        void _allocate_set();
+
+        void _create_min_lods();
+
+        void _write(std::uint32_t index, const VkDescriptorImageInfo& image_info);
+
+        void _validate_index(std::uint32_t index) const;
+    };
+}  // namespace fr
@@ -0,0 +1,278 @@
+#include "bindless_texture_table.h"
+#include "utils/buffer_utils.h"
+#include "utils/error.h"
+
+#include <algorithm>
+#include <array>
+
+namespace fr {
+    BindlessTextureTable::BindlessTextureTable(const std::shared_ptr<VkContext>& context, const std::uint32_t capacity)
+        : _context(context)
+        , _min_lods(&context->device, &context->allocator)
+    {
+        if (!_context->features.descriptor_indexing) {
+            throw std::runtime_error("Bindless texture tables require descriptor indexing, which the device does not support.");
+        }
+
+        const std::uint32_t max_descriptors = _query_max_descriptors();
+        _capacity = std::min(capacity, max_descriptors);
+        if (_capacity == 0) {
+            throw std::runtime_error("Bindless texture table capacity must be greater than zero.");
+        }
+
+        _allocated.assign(_capacity, false);
+
+        // Hand out the lowest slots first
+        _free_slots.reserve(_capacity);
+        for (std::uint32_t index = _capacity; index > 0; --index) {
+            _free_slots.push_back(index - 1);
+        }
+
+        _create_layout();
+        _create_pool();
+        _allocate_set();
+        _create_min_lods();
+    }
+
+    BindlessTextureTable::~BindlessTextureTable() {
+        // The pool owns the set
+        vkDestroyDescriptorPool(_context->device, _pool, nullptr);
+        vkDestroyDescriptorSetLayout(_context->device, _layout, nullptr);
+    }
+
+    std::uint32_t BindlessTextureTable::add(const VkDescriptorImageInfo& image_info, const float min_lod) {
+        if (_free_slots.empty()) {
+            throw std::runtime_error("Bindless texture table is full.");
+        }
+
+        const std::uint32_t index = _free_slots.back();
+        _free_slots.pop_back();
+
+        _allocated[index] = true;
+        ++_used;
+
+        // Recycled slots still hold the previous texture's clamp
+        _write(index, image_info);
+        set_min_lod(index, min_lod);
+        return index;
+    }
+
+    void BindlessTextureTable::update(const std::uint32_t index, const VkDescriptorImageInfo& image_info) {
+        _validate_index(index);
+        _write(index, image_info);
+    }
+
+    void BindlessTextureTable::set_min_lod(const std::uint32_t index, const float min_lod) {
+        _validate_index(index);
+
+        validate(
+            vmaCopyMemoryToAllocation(_context->allocator, &min_lod, _min_lods.allocation, index * sizeof(float), sizeof(float)),
+            "Failed to write bindless texture min LOD."
+        );
+    }
+
+    void BindlessTextureTable::remove(const std::uint32_t index) {
+        _validate_index(index);
+
+        _allocated[index] = false;
+        --_used;
+
+        // Frames in flight may still sample the slot, so it is not rewritten until they have completed
+        _retired_slots.push_back(RetiredSlot {index, _frame});
+    }
+
+    void BindlessTextureTable::end_frame() {
+        ++_frame;
+
+        const std::uint64_t frames_in_flight = std::max<std::size_t>(_context->per_frame.size(), 1);
+        std::erase_if(_retired_slots, [&](const RetiredSlot& slot) {
+            if (_frame - slot.frame < frames_in_flight) {
+                return false;
+            }
+
+            _free_slots.push_back(slot.index);
+            return true;
+        });
+    }
+
+    VkDescriptorSetLayout BindlessTextureTable::get_layout() const {
+        return _layout;
+    }
+
+    VkDescriptorSet BindlessTextureTable::get_descriptor_set() const {
+        return _descriptor;
+    }
+
+    std::uint32_t BindlessTextureTable::get_capacity() const {
+        return _capacity;
+    }
+
+    std::uint32_t BindlessTextureTable::size() const {
+        return _used;
+    }
+
+    std::uint32_t BindlessTextureTable::_query_max_descriptors() const {
+        VkPhysicalDeviceVulkan12Properties vulkan12_properties {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES
+        };
+
+        VkPhysicalDeviceProperties2 properties {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &vulkan12_properties
+        };
+        vkGetPhysicalDeviceProperties2(_context->gpu, &properties);
+
+        // Combined image samplers count against both the sampled image and the sampler limits
+        return std::min({
+            vulkan12_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+            vulkan12_properties.maxDescriptorSetUpdateAfterBindSamplers,
+            vulkan12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            vulkan12_properties.maxPerStageDescriptorUpdateAfterBindSamplers
+        });
+    }
+
+    void BindlessTextureTable::_create_layout() {
+        // descriptorCount is the upper bound of the variable sized array; the pipeline layout counts it against the
+        //  per-stage limits, so it is the capacity rather than the device maximum
+        const std::array layout_bindings {
+            VkDescriptorSetLayoutBinding {
+                .binding         = min_lod_binding,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = 1,
+                .stageFlags      = VK_SHADER_STAGE_ALL_GRAPHICS
+            },
+            VkDescriptorSetLayoutBinding {
+                .binding         = binding,
+                .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .descriptorCount = _capacity,
+                .stageFlags      = VK_SHADER_STAGE_ALL_GRAPHICS
+            }
+        };
+
+        // The min LOD buffer is written once, before the set is ever bound; only its contents change afterwards
+        const std::array<VkDescriptorBindingFlags, 2> binding_flags {
+            0,
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+            VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT
+        };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info {
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount  = static_cast<std::uint32_t>(binding_flags.size()),
+            .pBindingFlags = binding_flags.data()
+        };
+
+        VkDescriptorSetLayoutCreateInfo set_create_info {
+            .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext        = &binding_flags_info,
+            .flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+            .bindingCount = static_cast<std::uint32_t>(layout_bindings.size()),
+            .pBindings    = layout_bindings.data()
+        };
+
+        validate(
+            vkCreateDescriptorSetLayout(_context->device, &set_create_info, nullptr, &_layout),
+            "Failed to create bindless descriptor set layout."
+        );
+    }
+
+    void BindlessTextureTable::_create_pool() {
+        const std::array pool_sizes {
+            VkDescriptorPoolSize {
+                .type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = 1
+            },
+            VkDescriptorPoolSize {
+                .type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .descriptorCount = _capacity
+            }
+        };
+
+        VkDescriptorPoolCreateInfo pool_info {
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+            .maxSets       = 1,
+            .poolSizeCount = static_cast<std::uint32_t>(pool_sizes.size()),
+            .pPoolSizes    = pool_sizes.data()
+        };
+
+        validate(
+            vkCreateDescriptorPool(_context->device, &pool_info, nullptr, &_pool),
+            "Failed to create bindless descriptor pool."
+        );
+    }
+
+    void BindlessTextureTable::_allocate_set() {
+        VkDescriptorSetVariableDescriptorCountAllocateInfo variable_count_info {
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+            .descriptorSetCount = 1,
+            .pDescriptorCounts  = &_capacity
+        };
+
+        VkDescriptorSetAllocateInfo set_alloc_info {
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .pNext              = &variable_count_info,
+            .descriptorPool     = _pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts        = &_layout
+        };
+
+        validate(
+            vkAllocateDescriptorSets(_context->device, &set_alloc_info, &_descriptor),
+            "Failed to create bindless descriptor set."
+        );
+    }
+
+    void BindlessTextureTable::_create_min_lods() {
+        const VkDeviceSize size = static_cast<VkDeviceSize>(_capacity) * sizeof(float);
+
+        auto buffer_utils = BufferUtils(_context);
+        buffer_utils.create_buffer(_min_lods, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+        const std::vector<float> zeros(_capacity, 0.0f);
+        validate(
+            vmaCopyMemoryToAllocation(_context->allocator, zeros.data(), _min_lods.allocation, 0, size),
+            "Failed to clear bindless texture min LODs."
+        );
+
+        VkDescriptorBufferInfo buffer_info {
+            .buffer = _min_lods.buffer,
+            .offset = 0,
+            .range  = size
+        };
+
+        VkWriteDescriptorSet write_descriptor {
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = _descriptor,
+            .dstBinding      = min_lod_binding,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo     = &buffer_info
+        };
+
+        vkUpdateDescriptorSets(_context->device, 1, &write_descriptor, 0, nullptr);
+    }
+
+    void BindlessTextureTable::_write(const std::uint32_t index, const VkDescriptorImageInfo& image_info) {
+        VkWriteDescriptorSet write_descriptor {
+            .sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet          = _descriptor,
+            .dstBinding      = binding,
+            .dstArrayElement = index,
+            .descriptorCount = 1,
+            .descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .pImageInfo      = &image_info
+        };
+
+        vkUpdateDescriptorSets(_context->device, 1, &write_descriptor, 0, nullptr);
+    }
+
+    void BindlessTextureTable::_validate_index(const std::uint32_t index) const {
+        if (index >= _capacity || !_allocated[index]) {
+            throw std::runtime_error("Bindless texture table slot is not in use.");
+        }
+    }
+}  // namespace fr
@@ -0,0 +1,215 @@
+#include "descriptor_allocator.h"
+#include "utils/error.h"
+#include "utils/file_system.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace fr {
+    bool DescriptorLayoutKey::operator==(const DescriptorLayoutKey& other) const {
+        return flags == other.flags && std::equal(
+            bindings.begin(), bindings.end(), other.bindings.begin(), other.bindings.end(),
+            [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+                return a.binding == b.binding
+                    && a.descriptorType == b.descriptorType
+                    && a.descriptorCount == b.descriptorCount
+                    && a.stageFlags == b.stageFlags;
+            }
+        );
+    }
+
+    std::size_t DescriptorLayoutKeyHash::operator()(const DescriptorLayoutKey& key) const {
+        std::uint64_t hash = file_system::hash_bytes(&key.flags, sizeof(key.flags));
+        for (const auto& binding : key.bindings) {
+            hash = file_system::hash_bytes(&binding.binding, sizeof(binding.binding), hash);
+            hash = file_system::hash_bytes(&binding.descriptorType, sizeof(binding.descriptorType), hash);
+            hash = file_system::hash_bytes(&binding.descriptorCount, sizeof(binding.descriptorCount), hash);
+            hash = file_system::hash_bytes(&binding.stageFlags, sizeof(binding.stageFlags), hash);
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+
+    DescriptorLayoutCache::DescriptorLayoutCache(VkDevice device)
+        : _device(device)
+    { }
+
+    DescriptorLayoutCache::~DescriptorLayoutCache() {
+        for (const auto& [key, layout] : _layouts) {
+            vkDestroyDescriptorSetLayout(_device, layout, nullptr);
+        }
+    }
+
+    VkDescriptorSetLayout DescriptorLayoutCache::get(std::vector<VkDescriptorSetLayoutBinding> bindings, const VkDescriptorSetLayoutCreateFlags flags) {
+        for (const auto& binding : bindings) {
+            if (binding.pImmutableSamplers != nullptr) {
+                throw std::runtime_error("Cached descriptor set layouts cannot use immutable samplers.");
+            }
+        }
+
+        std::sort(bindings.begin(), bindings.end(), [](const auto& a, const auto& b) { return a.binding < b.binding; });
+        DescriptorLayoutKey key {
+            .flags    = flags,
+            .bindings = std::move(bindings)
+        };
+
+        std::lock_guard lock(_mutex);
+        if (const auto it = _layouts.find(key); it != _layouts.end()) {
+            return it->second;
+        }
+
+        VkDescriptorSetLayoutCreateInfo set_create_info {
+            .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .flags        = flags,
+            .bindingCount = static_cast<std::uint32_t>(key.bindings.size()),
+            .pBindings    = key.bindings.data()
+        };
+
+        VkDescriptorSetLayout layout;
+        validate(
+            vkCreateDescriptorSetLayout(_device, &set_create_info, nullptr, &layout),
+            "Failed to create descriptor set layout."
+        );
+
+        _layouts.emplace(std::move(key), layout);
+        return layout;
+    }
+
+    std::size_t DescriptorLayoutCache::size() const {
+        std::lock_guard lock(_mutex);
+        return _layouts.size();
+    }
+
+    const std::vector<DescriptorAllocator::PoolRatio> DescriptorAllocator::default_ratios = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,         2.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         2.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2.0f},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          2.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          1.0f},
+        {VK_DESCRIPTOR_TYPE_SAMPLER,                0.5f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 0.5f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 0.5f}
+    };
+
+    DescriptorAllocator::DescriptorAllocator(VkDevice device, const std::uint32_t initial_sets, std::vector<PoolRatio> ratios, const VkDescriptorPoolCreateFlags pool_flags)
+        : _device(device)
+        , _sets_per_pool(std::clamp(initial_sets, 1u, max_sets_per_pool))
+        , _ratios(std::move(ratios))
+        , _pool_flags(pool_flags)
+    { }
+
+    DescriptorAllocator::~DescriptorAllocator() {
+        // Pools own their sets
+        vkDestroyDescriptorPool(_device, _current_pool, nullptr);
+
+        for (auto pool : _ready_pools) {
+            vkDestroyDescriptorPool(_device, pool, nullptr);
+        }
+
+        for (auto pool : _full_pools) {
+            vkDestroyDescriptorPool(_device, pool, nullptr);
+        }
+    }
+
+    VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout, const void* next) {
+        std::lock_guard lock(_mutex);
+
+        if (_current_pool == VK_NULL_HANDLE) {
+            _current_pool = _next_pool();
+        }
+
+        VkDescriptorSetAllocateInfo set_alloc_info {
+            .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .pNext              = next,
+            .descriptorPool     = _current_pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts        = &layout
+        };
+
+        VkDescriptorSet descriptor;
+        VkResult result = vkAllocateDescriptorSets(_device, &set_alloc_info, &descriptor);
+
+        // The current pool is exhausted: retire it and retry once from a new one. A pool that has not served a set yet
+        //     is not exhausted, the layout needs more than a pool holds and a new pool would fail just the same.
+        if ((result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) && _current_pool_used) {
+            _full_pools.push_back(_current_pool);
+            _current_pool = _next_pool();
+            _current_pool_used = false;
+
+            set_alloc_info.descriptorPool = _current_pool;
+            result = vkAllocateDescriptorSets(_device, &set_alloc_info, &descriptor);
+        }
+
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY) {
+            throw std::runtime_error("Descriptor set layout uses descriptor types or counts the allocator's pool ratios do not cover.");
+        }
+
+        validate(result, "Failed to allocate descriptor set.");
+        _current_pool_used = true;
+
+        return descriptor;
+    }
+
+    void DescriptorAllocator::reset() {
+        std::lock_guard lock(_mutex);
+
+        if (_current_pool != VK_NULL_HANDLE) {
+            _full_pools.push_back(_current_pool);
+            _current_pool = VK_NULL_HANDLE;
+            _current_pool_used = false;
+        }
+
+        for (auto pool : _full_pools) {
+            vkResetDescriptorPool(_device, pool, 0);
+            _ready_pools.push_back(pool);
+        }
+        _full_pools.clear();
+    }
+
+    std::size_t DescriptorAllocator::pool_count() const {
+        std::lock_guard lock(_mutex);
+        return _ready_pools.size() + _full_pools.size() + (_current_pool != VK_NULL_HANDLE ? 1 : 0);
+    }
+
+    VkDescriptorPool DescriptorAllocator::_next_pool() {
+        if (!_ready_pools.empty()) {
+            VkDescriptorPool pool = _ready_pools.back();
+            _ready_pools.pop_back();
+            return pool;
+        }
+
+        // Each new pool is larger than the last, so long lived allocators settle on a handful of pools
+        VkDescriptorPool pool = _create_pool(_sets_per_pool);
+        _sets_per_pool = std::min(_sets_per_pool + _sets_per_pool / 2, max_sets_per_pool);
+
+        return pool;
+    }
+
+    VkDescriptorPool DescriptorAllocator::_create_pool(const std::uint32_t max_sets) const {
+        std::vector<VkDescriptorPoolSize> pool_sizes;
+        pool_sizes.reserve(_ratios.size());
+
+        for (const auto& [type, ratio] : _ratios) {
+            pool_sizes.push_back(VkDescriptorPoolSize {
+                .type            = type,
+                .descriptorCount = std::max(static_cast<std::uint32_t>(ratio * static_cast<float>(max_sets)), 1u)
+            });
+        }
+
+        VkDescriptorPoolCreateInfo pool_info {
+            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags         = _pool_flags,
+            .maxSets       = max_sets,
+            .poolSizeCount = static_cast<std::uint32_t>(pool_sizes.size()),
+            .pPoolSizes    = pool_sizes.data()
+        };
+
+        VkDescriptorPool pool;
+        validate(
+            vkCreateDescriptorPool(_device, &pool_info, nullptr, &pool),
+            "Failed to create descriptor pool."
+        );
+
+        return pool;
+    }
+}  // namespace fr
@@ -0,0 +1,247 @@
+#include "descriptor_buffer.h"
+#include "utils/buffer_utils.h"
+#include "utils/error.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace fr {
+    DescriptorBuffer::DescriptorBuffer(const std::shared_ptr<VkContext>& context, const std::vector<DescriptorInfo>& info, const std::uint32_t capacity)
+        : _context(context)
+        , _buffer(&context->device, &context->allocator)
+        , _capacity(capacity)
+    {
+        if (!_context->features.descriptor_buffer) {
+            throw std::runtime_error("Descriptor buffers are not supported by the device.");
+        }
+
+        if (_capacity == 0) {
+            throw std::runtime_error("Descriptor buffer capacity must be greater than zero.");
+        }
+
+        _allocated.assign(_capacity, false);
+
+        // Hand out the lowest slots first
+        _free_slots.reserve(_capacity);
+        for (std::uint32_t slot = _capacity; slot > 0; --slot) {
+            _free_slots.push_back(slot - 1);
+        }
+
+        _create_layout(info);
+        _create_buffer();
+    }
+
+    DescriptorBuffer::~DescriptorBuffer() {
+        vkDeviceWaitIdle(_context->device);
+
+        BufferUtils(_context).unmap_buffer(_buffer);
+        _buffer.destroy();
+    }
+
+    std::uint32_t DescriptorBuffer::allocate() {
+        std::lock_guard lock(_mutex);
+
+        if (_free_slots.empty()) {
+            throw std::runtime_error("Descriptor buffer is full.");
+        }
+
+        const std::uint32_t slot = _free_slots.back();
+        _free_slots.pop_back();
+        _allocated[slot] = true;
+
+        return slot;
+    }
+
+    void DescriptorBuffer::write(const std::uint32_t slot, const std::vector<DescriptorInfo>& info) {
+        {
+            std::lock_guard lock(_mutex);
+            _validate_slot(slot);
+        }
+
+        // Each slot is disjoint memory, so concurrent writes to different slots need no further locking
+        std::uint8_t* destination = _mapped + slot * _slot_size;
+        for (const auto& descriptor : info) {
+            const Binding& binding = _find_binding(descriptor.binding);
+            _write_descriptor(binding, descriptor, destination + binding.offset);
+        }
+
+        validate(
+            vmaFlushAllocation(_context->allocator, _buffer.allocation, slot * _slot_size, _slot_size),
+            "Failed to flush descriptor buffer slot."
+        );
+    }
+
+    void DescriptorBuffer::release(const std::uint32_t slot) {
+        std::lock_guard lock(_mutex);
+        _validate_slot(slot);
+
+        // Frames in flight may still read the slot, so it is not rewritten until they have completed
+        _allocated[slot] = false;
+        _retired_slots.push_back(RetiredSlot {slot, _frame});
+    }
+
+    void DescriptorBuffer::end_frame() {
+        std::lock_guard lock(_mutex);
+        ++_frame;
+
+        const std::uint64_t frames_in_flight = std::max<std::size_t>(_context->per_frame.size(), 1);
+        std::erase_if(_retired_slots, [&](const RetiredSlot& retired) {
+            if (_frame - retired.frame < frames_in_flight) {
+                return false;
+            }
+
+            _free_slots.push_back(retired.slot);
+            return true;
+        });
+    }
+
+    void DescriptorBuffer::bind(VkCommandBuffer command_buffer) const {
+        VkDescriptorBufferBindingInfoEXT binding_info {
+            .sType   = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+            .address = _buffer.address,
+            .usage   = _usage
+        };
+
+        _context->extensions.bind_descriptor_buffers(command_buffer, 1, &binding_info);
+    }
+
+    void DescriptorBuffer::bind_slot(VkCommandBuffer command_buffer, VkPipelineLayout pipeline_layout, const std::uint32_t set, const std::uint32_t slot) const {
+        const std::uint32_t buffer_index = 0;
+        const VkDeviceSize offset = slot * _slot_size;
+
+        _context->extensions.set_descriptor_buffer_offsets(
+            command_buffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipeline_layout,
+            set,
+            1,
+            &buffer_index,
+            &offset
+        );
+    }
+
+    VkDescriptorSetLayout DescriptorBuffer::get_layout() const {
+        return _layout;
+    }
+
+    std::uint32_t DescriptorBuffer::get_capacity() const {
+        return _capacity;
+    }
+
+    VkDeviceSize DescriptorBuffer::get_slot_size() const {
+        return _slot_size;
+    }
+
+    void DescriptorBuffer::_create_layout(const std::vector<DescriptorInfo>& info) {
+        auto descriptor_set = DescriptorSet(_context);
+        _layout = descriptor_set.get_descriptor_layout(info, VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT);
+
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT
+        };
+
+        VkPhysicalDeviceProperties2 properties {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &descriptor_buffer_properties
+        };
+        vkGetPhysicalDeviceProperties2(_context->gpu, &properties);
+
+        // Slots are bound by offset, which must honour the device's alignment
+        VkDeviceSize layout_size = 0;
+        _context->extensions.get_descriptor_set_layout_size(_context->device, _layout, &layout_size);
+
+        const VkDeviceSize alignment = descriptor_buffer_properties.descriptorBufferOffsetAlignment;
+        _slot_size = (layout_size + alignment - 1) / alignment * alignment;
+
+        for (const auto& descriptor : info) {
+            Binding binding {
+                .binding = descriptor.binding,
+                .type    = descriptor.type
+            };
+
+            switch (descriptor.type) {
+                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                    binding.size = descriptor_buffer_properties.uniformBufferDescriptorSize;
+                    _usage |= VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+                    break;
+                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                    binding.size = descriptor_buffer_properties.storageBufferDescriptorSize;
+                    _usage |= VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+                    break;
+                case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                    binding.size = descriptor_buffer_properties.combinedImageSamplerDescriptorSize;
+                    _usage |= VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+                    break;
+                default:
+                    throw std::runtime_error("Descriptor type is not supported by descriptor buffers.");
+            }
+
+            _context->extensions.get_descriptor_set_layout_binding_offset(_context->device, _layout, binding.binding, &binding.offset);
+            _bindings.push_back(binding);
+        }
+
+        std::sort(_bindings.begin(), _bindings.end(), [](const auto& a, const auto& b) { return a.binding < b.binding; });
+    }
+
+    void DescriptorBuffer::_create_buffer() {
+        auto buffer_utils = BufferUtils(_context);
+        buffer_utils.create_buffer(_buffer, _slot_size * _capacity, _usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+
+        // Persistently mapped: writes are plain stores into the buffer
+        _mapped = static_cast<std::uint8_t*>(buffer_utils.map_buffer(_buffer));
+    }
+
+    void DescriptorBuffer::_write_descriptor(const Binding& binding, const DescriptorInfo& info, std::uint8_t* destination) const {
+        if (binding.type != info.type) {
+            throw std::runtime_error("Descriptor info type does not match the descriptor buffer layout.");
+        }
+
+        VkDescriptorAddressInfoEXT address_info {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT
+        };
+
+        VkDescriptorGetInfoEXT get_info {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+            .type  = info.type
+        };
+
+        if (info.type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
+            get_info.data.pCombinedImageSampler = &info.image_info;
+        } else {
+            VkBufferDeviceAddressInfo buffer_address_info {
+                .sType  = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .buffer = info.buffer_info.buffer
+            };
+
+            address_info.address = vkGetBufferDeviceAddress(_context->device, &buffer_address_info) + info.buffer_info.offset;
+            address_info.range   = info.buffer_info.range;
+            address_info.format  = VK_FORMAT_UNDEFINED;
+
+            if (info.type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) {
+                get_info.data.pUniformBuffer = &address_info;
+            } else {
+                get_info.data.pStorageBuffer = &address_info;
+            }
+        }
+
+        _context->extensions.get_descriptor(_context->device, &get_info, binding.size, destination);
+    }
+
+    const DescriptorBuffer::Binding& DescriptorBuffer::_find_binding(const std::uint32_t binding) const {
+        const auto it = std::lower_bound(
+            _bindings.begin(), _bindings.end(), binding,
+            [](const Binding& a, const std::uint32_t b) { return a.binding < b; }
+        );
+        if (it == _bindings.end() || it->binding != binding) {
+            throw std::runtime_error("Descriptor info binding is not part of the descriptor buffer layout.");
+        }
+
+        return *it;
+    }
+
+    void DescriptorBuffer::_validate_slot(const std::uint32_t slot) const {
+        if (slot >= _capacity || !_allocated[slot]) {
+            throw std::runtime_error("Descriptor buffer slot is not in use.");
+        }
+    }
+}  // namespace fr
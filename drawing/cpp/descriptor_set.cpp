@@ -1,7 +1,9 @@
 #include "descriptor_set.h"
+#include "descriptor_allocator.h"
+#include "descriptor_template.h"
 #include "utils/error.h"
 
-#include <unordered_map>
+#include <stdexcept>
 
 namespace fr {
     DescriptorSet::DescriptorSet(std::shared_ptr<VkContext>& context)
@@ -9,51 +11,48 @@ namespace fr {
     { }
 
     void DescriptorSet::create_descriptor_sets(DescriptorCore& core, std::vector<DescriptorInfo>& info) {
-        std::vector<VkDescriptorSetLayoutBinding> layout_bindings = {};
-        layout_bindings.reserve(info.size());
-
-        std::vector<VkDescriptorPoolSize> pool_sizes = {};
-        pool_sizes.reserve(info.size());
-
-        std::vector<VkWriteDescriptorSet> write_descriptor_sets = {};
-        write_descriptor_sets.reserve(info.size());
+        core.layout = get_descriptor_layout(info);
+        core.descriptor = allocate_descriptor_set(info, *_context->descriptor_allocator);
+    }
 
+    VkDescriptorSet DescriptorSet::allocate_descriptor_set(std::vector<DescriptorInfo>& info, DescriptorAllocator& allocator) {
+        // Written with one templated update; callers writing the same bindings every frame should keep the template
+        auto descriptor_template = DescriptorTemplate(_context, info);
+        return descriptor_template.allocate(allocator, info);
+    }
 
-        std::unordered_map<VkDescriptorType, std::uint16_t> type_info = {};
-        for (auto& [type, flags, binding, size, buffer_info, image_info] : info) {
-            layout_bindings.emplace_back(create_descriptor_layout(type, flags, binding));
+    VkDescriptorSetLayout DescriptorSet::get_descriptor_layout(const std::vector<DescriptorInfo>& info, const VkDescriptorSetLayoutCreateFlags flags) {
+        std::vector<VkDescriptorSetLayoutBinding> layout_bindings = {};
+        layout_bindings.reserve(info.size());
 
-            type_info[type]++;  // Aggregate the type information
+        for (const auto& [type, stage_flags, binding, size, buffer_info, image_info] : info) {
+            layout_bindings.emplace_back(create_descriptor_layout(type, stage_flags, binding));
         }
 
-        for (const auto& [type, count] : type_info) {
-            pool_sizes.emplace_back(create_descriptor_pool(type, count));
-        }
+        return _context->descriptor_layout_cache->get(std::move(layout_bindings), flags);
+    }
 
-        set_descriptor_layout(core.layout, layout_bindings);
-        set_descriptor_pool(core.pool, pool_sizes, info.size());
+    VkDescriptorSetLayout DescriptorSet::get_push_descriptor_layout(const std::vector<DescriptorInfo>& info) {
+        if (!_context->features.push_descriptor) {
+            throw std::runtime_error("Push descriptors are not supported by the device.");
+        }
 
-        VkDescriptorSetAllocateInfo set_alloc_info {
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-            .descriptorPool = core.pool,
-            .descriptorSetCount = 1,
-            .pSetLayouts = &core.layout
-        };
+        return get_descriptor_layout(info, VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR);
+    }
 
-        validate(
-            vkAllocateDescriptorSets(_context->device, &set_alloc_info, &core.descriptor),
-            "Failed to create descriptor set."
-        );
+    std::vector<VkWriteDescriptorSet> DescriptorSet::create_descriptor_writes(VkDescriptorSet descriptor_set, std::vector<DescriptorInfo>& info) {
+        std::vector<VkWriteDescriptorSet> write_descriptor_sets = {};
+        write_descriptor_sets.reserve(info.size());
 
         for (auto& [type, flags, binding, size, buffer_info, image_info] : info) {
             if (type != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) {
-                write_descriptor_sets.emplace_back(create_descriptor_set(core.descriptor, &buffer_info, type, binding));
+                write_descriptor_sets.emplace_back(create_descriptor_set(descriptor_set, &buffer_info, type, binding));
             } else {
-                write_descriptor_sets.emplace_back(create_descriptor_set(core.descriptor, &image_info, type, binding));
+                write_descriptor_sets.emplace_back(create_descriptor_set(descriptor_set, &image_info, type, binding));
             }
         }
 
-        vkUpdateDescriptorSets(_context->device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0, nullptr);
+        return write_descriptor_sets;
     }
 
     VkDescriptorSetLayoutBinding DescriptorSet::create_descriptor_layout(const VkDescriptorType type, const VkShaderStageFlags flags, const std::uint32_t binding) {
@@ -65,40 +64,6 @@ namespace fr {
         };
     }
 
-    void DescriptorSet::set_descriptor_layout(VkDescriptorSetLayout& descriptor_set_layout, std::vector<VkDescriptorSetLayoutBinding>& layout_bindings) {
-        VkDescriptorSetLayoutCreateInfo set_create_info {
-            .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-            .bindingCount = static_cast<std::uint32_t>(layout_bindings.size()),
-            .pBindings    = layout_bindings.data()
-        };
-
-        validate(
-            vkCreateDescriptorSetLayout(_context->device, &set_create_info, nullptr, &descriptor_set_layout),
-            "Failed to create descriptor set layout."
-        );
-    }
-
-    VkDescriptorPoolSize DescriptorSet::create_descriptor_pool(const VkDescriptorType type, const std::uint32_t pool_size) {
-        return VkDescriptorPoolSize {
-            .type            = type,
-            .descriptorCount = pool_size
-        };
-    }
-
-    void DescriptorSet::set_descriptor_pool(VkDescriptorPool& descriptor_pool, std::vector<VkDescriptorPoolSize>& pool_sizes, const std::uint32_t max_sets) {
-        VkDescriptorPoolCreateInfo pool_info {
-            .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-            .maxSets       = max_sets,  // Maximum number of descriptor sets that can be allocated from the pool.
-            .poolSizeCount = 1,
-            .pPoolSizes    = pool_sizes.data()
-        };
-
-        validate(
-            vkCreateDescriptorPool(_context->device, &pool_info, nullptr, &descriptor_pool),
-            "Failed to create descriptor pool."
-        );
-    }
-
     VkWriteDescriptorSet DescriptorSet::create_descriptor_set(VkDescriptorSet& descriptor_set, VkDescriptorBufferInfo* buffer_info, VkDescriptorType type, std::uint32_t binding) {
         VkWriteDescriptorSet write_descriptor {
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
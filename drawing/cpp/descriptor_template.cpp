@@ -0,0 +1,125 @@
+#include "descriptor_template.h"
+#include "descriptor_allocator.h"
+#include "utils/error.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace fr {
+    DescriptorTemplate::DescriptorTemplate(const std::shared_ptr<VkContext>& context, const std::vector<DescriptorInfo>& info)
+        : _context(context)
+    {
+        auto descriptor_set = DescriptorSet(_context);
+        _layout = descriptor_set.get_descriptor_layout(info);
+
+        _bindings.reserve(info.size());
+        for (const auto& descriptor : info) {
+            _bindings.push_back(Binding {
+                .binding = descriptor.binding,
+                .type    = descriptor.type
+            });
+        }
+        std::sort(_bindings.begin(), _bindings.end(), [](const auto& a, const auto& b) { return a.binding < b.binding; });
+
+        const auto duplicate = std::adjacent_find(_bindings.begin(), _bindings.end(), [](const auto& a, const auto& b) { return a.binding == b.binding; });
+        if (duplicate != _bindings.end()) {
+            throw std::runtime_error("Descriptor template bindings must be unique.");
+        }
+
+        std::vector<VkDescriptorUpdateTemplateEntry> template_entries;
+        template_entries.reserve(_bindings.size());
+        for (std::size_t i = 0; i < _bindings.size(); ++i) {
+            template_entries.push_back(VkDescriptorUpdateTemplateEntry {
+                .dstBinding      = _bindings[i].binding,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType  = _bindings[i].type,
+                .offset          = i * sizeof(DescriptorTemplateEntry),
+                .stride          = sizeof(DescriptorTemplateEntry)
+            });
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo template_info {
+            .sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+            .descriptorUpdateEntryCount = static_cast<std::uint32_t>(template_entries.size()),
+            .pDescriptorUpdateEntries   = template_entries.data(),
+            .templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+            .descriptorSetLayout        = _layout
+        };
+
+        validate(
+            vkCreateDescriptorUpdateTemplate(_context->device, &template_info, nullptr, &_template),
+            "Failed to create descriptor update template."
+        );
+    }
+
+    DescriptorTemplate::~DescriptorTemplate() {
+        vkDestroyDescriptorUpdateTemplate(_context->device, _template, nullptr);
+    }
+
+    VkDescriptorSet DescriptorTemplate::allocate(DescriptorAllocator& allocator, const std::vector<DescriptorInfo>& info) {
+        VkDescriptorSet descriptor_set = allocator.allocate(_layout);
+        update(descriptor_set, info);
+
+        return descriptor_set;
+    }
+
+    void DescriptorTemplate::update(VkDescriptorSet descriptor_set, const std::vector<DescriptorInfo>& info) {
+        pack(info, _entries);
+        update(descriptor_set, _entries);
+    }
+
+    void DescriptorTemplate::update(VkDescriptorSet descriptor_set, const std::span<const DescriptorTemplateEntry> entries) const {
+        if (entries.size() != _bindings.size()) {
+            throw std::runtime_error("Descriptor template entry count does not match its bindings.");
+        }
+
+        vkUpdateDescriptorSetWithTemplate(_context->device, descriptor_set, _template, entries.data());
+    }
+
+    void DescriptorTemplate::pack(const std::vector<DescriptorInfo>& info, std::vector<DescriptorTemplateEntry>& entries) const {
+        if (info.size() != _bindings.size()) {
+            throw std::runtime_error("Descriptor infos do not match the template's bindings.");
+        }
+
+        // Every binding must be written exactly once, a duplicate would leave another binding's entry stale
+        std::vector<bool> written(_bindings.size(), false);
+
+        entries.resize(_bindings.size());
+        for (const auto& descriptor : info) {
+            const auto it = std::lower_bound(
+                _bindings.begin(), _bindings.end(), descriptor.binding,
+                [](const Binding& a, const std::uint32_t binding) { return a.binding < binding; }
+            );
+            if (it == _bindings.end() || it->binding != descriptor.binding || it->type != descriptor.type) {
+                throw std::runtime_error("Descriptor info binding is not part of the template.");
+            }
+
+            const auto index = static_cast<std::size_t>(it - _bindings.begin());
+            if (written[index]) {
+                throw std::runtime_error("Descriptor info binding is written more than once.");
+            }
+            written[index] = true;
+
+            auto& entry = entries[index];
+            if (_is_image(descriptor.type)) {
+                entry.image_info = descriptor.image_info;
+            } else {
+                entry.buffer_info = descriptor.buffer_info;
+            }
+        }
+    }
+
+    VkDescriptorSetLayout DescriptorTemplate::get_layout() const {
+        return _layout;
+    }
+
+    std::size_t DescriptorTemplate::get_entry_count() const {
+        return _bindings.size();
+    }
+
+    bool DescriptorTemplate::_is_image(const VkDescriptorType type) {
+        // Mirrors DescriptorSet::allocate_descriptor_set, which only writes image infos for combined image samplers
+        return type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    }
+}  // namespace fr
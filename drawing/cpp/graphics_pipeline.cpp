@@ -1,23 +1,204 @@
 #include "graphics_pipeline.h"
+#include "descriptor_allocator.h"
 #include "utils/error.h"
+#include "utils/file_system.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace fr {
+    namespace {
+        template<typename T>
+        std::uint64_t hash_value(const T& value, const std::uint64_t seed) {
+            return file_system::hash_bytes(&value, sizeof(value), seed);
+        }
+
+        /// The Vulkan structs compared this way hold no padding
+        template<typename T>
+        bool equal_bytes(const std::vector<T>& a, const std::vector<T>& b) {
+            return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+        }
+
+        bool equal_stages(const PipelineStage& a, const PipelineStage& b) {
+            // Handles are not compared, a destroyed module's handle can be reused for different code
+            return a.stage == b.stage
+                && a.code_hash == b.code_hash
+                && a.entry_point == b.entry_point
+                && equal_bytes(a.specialization.get_entries(), b.specialization.get_entries())
+                && a.specialization.get_data() == b.specialization.get_data();
+        }
+    }
+
+    std::uint64_t PipelineDescription::hash() const {
+        std::uint64_t result = file_system::hash_bytes(nullptr, 0);
+
+        for (const auto& [stage, module, entry_point, code_hash, specialization] : stages) {
+            result = hash_value(stage, result);
+            result = hash_value(code_hash, result);
+            result = file_system::hash_bytes(entry_point.data(), entry_point.size(), result);
+
+            for (const auto& entry : specialization.get_entries()) {
+                result = hash_value(entry.constantID, result);
+                result = hash_value(entry.offset, result);
+                result = hash_value(entry.size, result);
+            }
+            result = file_system::hash_bytes(specialization.get_data().data(), specialization.get_data().size(), result);
+        }
+
+        for (const auto& binding : vertex_info.binding_description) {
+            result = hash_value(binding.binding, result);
+            result = hash_value(binding.stride, result);
+            result = hash_value(binding.inputRate, result);
+        }
+
+        for (const auto& attribute : vertex_info.attribute_descriptions) {
+            result = hash_value(attribute.location, result);
+            result = hash_value(attribute.binding, result);
+            result = hash_value(attribute.format, result);
+            result = hash_value(attribute.offset, result);
+        }
+
+        for (const auto& set_layout : set_layouts) {
+            result = hash_value(set_layout, result);
+        }
+
+        for (const auto& range : push_constant_ranges) {
+            result = hash_value(range.stageFlags, result);
+            result = hash_value(range.offset, result);
+            result = hash_value(range.size, result);
+        }
+
+        result = hash_value(color_format, result);
+        result = hash_value(depth_format, result);
+        result = hash_value(depth_test, result);
+        result = hash_value(depth_write, result);
+        result = hash_value(depth_compare_op, result);
+        result = hash_value(alpha_blend, result);
+        result = hash_value(flags, result);
+
+        return result;
+    }
+
+    bool PipelineDescription::operator==(const PipelineDescription& other) const {
+        return std::ranges::equal(stages, other.stages, equal_stages)
+            && equal_bytes(vertex_info.binding_description, other.vertex_info.binding_description)
+            && equal_bytes(vertex_info.attribute_descriptions, other.vertex_info.attribute_descriptions)
+            && set_layouts == other.set_layouts
+            && equal_bytes(push_constant_ranges, other.push_constant_ranges)
+            && color_format == other.color_format
+            && depth_format == other.depth_format
+            && depth_test == other.depth_test
+            && depth_write == other.depth_write
+            && depth_compare_op == other.depth_compare_op
+            && alpha_blend == other.alpha_blend
+            && flags == other.flags;
+    }
+
     GraphicsPipeline::GraphicsPipeline(std::shared_ptr<VkContext>& context)
         : _context(context)
     { }
 
-    void GraphicsPipeline::create_pipeline(const VertexInfo& vertex_info, std::vector<VkPipelineShaderStageCreateInfo>& shader_stages) {
+    void GraphicsPipeline::create_pipeline(
+        const VertexInfo& vertex_info,
+        std::vector<VkPipelineShaderStageCreateInfo>& shader_stages,
+        const std::vector<VkPushConstantRange>& push_constant_ranges,
+        const std::vector<VkDescriptorSetLayout>& additional_set_layouts,
+        const bool descriptor_buffer
+    ) {
+        const PipelineDescription description = describe(vertex_info, shader_stages, 0, push_constant_ranges, additional_set_layouts, descriptor_buffer);
+
+        _context->pipeline_layout = create_pipeline_layout(*_context, description);
+        _context->pipeline = create_pipeline(*_context, description, _context->pipeline_layout);
+    }
+
+    PipelineDescription GraphicsPipeline::describe(
+        const VertexInfo& vertex_info,
+        const std::vector<VkPipelineShaderStageCreateInfo>& shader_stages,
+        const std::uint64_t code_hash,
+        const std::vector<VkPushConstantRange>& push_constant_ranges,
+        const std::vector<VkDescriptorSetLayout>& additional_set_layouts,
+        const bool descriptor_buffer
+    ) const {
+        PipelineDescription description {
+            .vertex_info          = vertex_info,
+            .push_constant_ranges = push_constant_ranges,
+            .color_format         = _context->swap_chain_dimensions.format,
+            .depth_format         = _context->depth_format,
+            .flags                = descriptor_buffer ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u
+        };
+
+        for (const auto& stage : shader_stages) {
+            description.stages.push_back(PipelineStage {
+                .stage          = stage.stage,
+                .module         = stage.module,
+                .entry_point    = stage.pName,
+                .code_hash      = code_hash,
+                .specialization = stage.pSpecializationInfo != nullptr ? SpecializationConstants(*stage.pSpecializationInfo) : SpecializationConstants()
+            });
+        }
+
+        // A descriptor buffer pipeline cannot bind descriptor sets, so the context's set is left out
+        if (!descriptor_buffer) {
+            description.set_layouts.push_back(_context->descriptor.layout);
+        }
+        description.set_layouts.insert(description.set_layouts.end(), additional_set_layouts.begin(), additional_set_layouts.end());
+
+        // Unused set indices below a used one still need a layout, an empty one stands in for them
+        const VkDescriptorSetLayoutCreateFlags placeholder_flags = descriptor_buffer ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u;
+        for (auto& set_layout : description.set_layouts) {
+            if (set_layout == VK_NULL_HANDLE) {
+                set_layout = _context->descriptor_layout_cache->get({}, placeholder_flags);
+            }
+        }
+
+        return description;
+    }
+
+    VkPipelineLayout GraphicsPipeline::create_pipeline_layout(const VkContext& context, const PipelineDescription& description) {
         // Create a dynamic pipeline
         VkPipelineLayoutCreateInfo pipeline_layout_info {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-            .setLayoutCount = 1,
-            .pSetLayouts = &_context->descriptor.layout
+            .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount         = static_cast<std::uint32_t>(description.set_layouts.size()),
+            .pSetLayouts            = description.set_layouts.data(),
+            .pushConstantRangeCount = static_cast<std::uint32_t>(description.push_constant_ranges.size()),
+            .pPushConstantRanges    = description.push_constant_ranges.data()
         };
+
+        VkPipelineLayout pipeline_layout;
         validate(
-            vkCreatePipelineLayout(_context->device, &pipeline_layout_info, nullptr, &_context->pipeline_layout),
+            vkCreatePipelineLayout(context.device, &pipeline_layout_info, nullptr, &pipeline_layout),
             "Failed to create pipeline layout!"
         );
 
+        return pipeline_layout;
+    }
+
+    VkPipeline GraphicsPipeline::create_pipeline(const VkContext& context, const PipelineDescription& description, VkPipelineLayout layout) {
+        // Sized up front, the stages point into it
+        std::vector<VkSpecializationInfo> specialization_infos;
+        specialization_infos.reserve(description.stages.size());
+
+        std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
+        shader_stages.reserve(description.stages.size());
+        for (const auto& stage : description.stages) {
+            const VkSpecializationInfo* specialization_info = nullptr;
+            if (!stage.specialization.empty()) {
+                specialization_info = &specialization_infos.emplace_back(stage.specialization.get_info());
+            }
+
+            shader_stages.push_back(VkPipelineShaderStageCreateInfo {
+                .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage               = stage.stage,
+                .module              = stage.module,
+                .pName               = stage.entry_point.c_str(),
+                .pSpecializationInfo = specialization_info
+            });
+        }
+
+        // The description may have been copied, so the vertex input state is rebuilt against its own arrays
+        VertexInfo vertex_info = description.vertex_info;
+        vertex_info.generate_vertex_info();
+
         // Specify that we will use triangle lists for drawing the geometry
         VkPipelineInputAssemblyStateCreateInfo input_assembly {
             .sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
@@ -44,9 +225,16 @@ namespace fr {
             VK_DYNAMIC_STATE_POLYGON_MODE_EXT
         };
 
-        // Enable RGBA colour channels, but no blending is enabled
+        // Enable RGBA colour channels, blending only for overlays that ask for it
         VkPipelineColorBlendAttachmentState blend_attachment {
-            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+            .blendEnable         = description.alpha_blend ? VK_TRUE : VK_FALSE,
+            .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+            .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+            .colorBlendOp        = VK_BLEND_OP_ADD,
+            .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+            .dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+            .alphaBlendOp        = VK_BLEND_OP_ADD,
+            .colorWriteMask      = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
         };
 
         VkPipelineColorBlendStateCreateInfo blend {
@@ -62,12 +250,11 @@ namespace fr {
             .scissorCount  = 1
         };
 
-        // Disable depth testing
         VkPipelineDepthStencilStateCreateInfo depth_stencil {
             .sType            = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-            .depthTestEnable  = VK_TRUE,
-            .depthWriteEnable = VK_TRUE,
-            .depthCompareOp   = VK_COMPARE_OP_LESS
+            .depthTestEnable  = description.depth_test ? VK_TRUE : VK_FALSE,
+            .depthWriteEnable = description.depth_write ? VK_TRUE : VK_FALSE,
+            .depthCompareOp   = description.depth_compare_op
         };
 
         // No multisampling.
@@ -87,14 +274,15 @@ namespace fr {
         VkPipelineRenderingCreateInfo pipeline_rendering_info {
             .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
             .colorAttachmentCount    = 1,
-            .pColorAttachmentFormats = &_context->swap_chain_dimensions.format,
-            .depthAttachmentFormat   = _context->depth_format
+            .pColorAttachmentFormats = &description.color_format,
+            .depthAttachmentFormat   = description.depth_format
         };
 
         // Create the graphics pipeline.
         VkGraphicsPipelineCreateInfo pipe {
             .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
             .pNext               = &pipeline_rendering_info,
+            .flags               = description.flags,
             .stageCount          = static_cast<std::uint32_t>(shader_stages.size()),
             .pStages             = shader_stages.data(),
             .pVertexInputState   = &vertex_info.vertex_info,
@@ -105,14 +293,17 @@ namespace fr {
             .pDepthStencilState  = &depth_stencil,
             .pColorBlendState    = &blend,
             .pDynamicState       = &dynamic_state_info,
-            .layout              = _context->pipeline_layout,        // We need to specify the pipeline layout description up front as well.
+            .layout              = layout,                           // We need to specify the pipeline layout description up front as well.
             .renderPass          = VK_NULL_HANDLE,                   // Since we are using dynamic rendering this will set as null
             .subpass             = 0
         };
 
+        VkPipeline pipeline;
         validate(
-            vkCreateGraphicsPipelines(_context->device, VK_NULL_HANDLE, 1, &pipe, nullptr, &_context->pipeline),
+            vkCreateGraphicsPipelines(context.device, context.pipeline_cache->get(), 1, &pipe, nullptr, &pipeline),
             "Failed to create graphics pipeline."
         );
+
+        return pipeline;
     }
 }
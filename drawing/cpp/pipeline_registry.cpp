@@ -0,0 +1,237 @@
+#include "pipeline_registry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace fr {
+    PipelineRegistry::PipelineRegistry(const std::shared_ptr<VkContext>& context, const std::size_t n_threads)
+        : _context(context)
+        , _workers(n_threads)
+    { }
+
+    PipelineRegistry::~PipelineRegistry() {
+        // Workers still write into the entries, so they must finish before anything is destroyed
+        for (const auto& [handle, entry] : _entries) {
+            if (entry->compiled.valid()) {
+                entry->compiled.wait();
+            }
+        }
+        for (const auto& retired : _retired) {
+            if (retired.entry->compiled.valid()) {
+                retired.entry->compiled.wait();
+            }
+        }
+
+        vkDeviceWaitIdle(_context->device);
+
+        for (const auto& [handle, entry] : _entries) {
+            _destroy(*entry);
+        }
+        for (const auto& retired : _retired) {
+            _destroy(*retired.entry);
+        }
+    }
+
+    PipelineRegistry::Handle PipelineRegistry::request(const PipelineDescription& description) {
+        _validate(description);
+
+        Handle handle = 0;
+
+        std::lock_guard lock(_mutex);
+        if (_lookup(description, handle) != nullptr) {
+            return handle;
+        }
+
+        Entry& entry = _insert(handle, description);
+
+        // The description is copied into the task, the caller's may go out of scope
+        entry.compiled = _workers.submit([this, &entry, handle, description] {
+            _compile(entry, handle, description);
+        }).share();
+
+        return handle;
+    }
+
+    PipelineRegistry::Variant PipelineRegistry::require(const PipelineDescription& description) {
+        _validate(description);
+
+        Handle handle = 0;
+
+        Entry* entry = nullptr;
+        std::promise<void> compiled;
+        bool compile_here = false;
+        {
+            std::lock_guard lock(_mutex);
+            entry = _lookup(description, handle);
+            if (entry == nullptr) {
+                // Published before compiling, so concurrent callers wait instead of compiling the variant again
+                entry = &_insert(handle, description);
+                entry->compiled = compiled.get_future().share();
+                compile_here = true;
+            }
+        }
+
+        if (compile_here) {
+            _compile(*entry, handle, description);
+            compiled.set_value();
+        }
+
+        wait(handle);
+        return entry->variant;
+    }
+
+    std::optional<PipelineRegistry::Variant> PipelineRegistry::resolve(const Handle handle, const std::optional<Handle> fallback) const {
+        std::lock_guard lock(_mutex);
+
+        const Entry& entry = _find(handle);
+        if (entry.error) {
+            std::rethrow_exception(entry.error);
+        }
+
+        if (entry.ready) {
+            return entry.variant;
+        }
+
+        if (fallback.has_value()) {
+            const Entry& fallback_entry = _find(*fallback);
+            if (fallback_entry.ready) {
+                return fallback_entry.variant;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    bool PipelineRegistry::is_ready(const Handle handle) const {
+        std::lock_guard lock(_mutex);
+        return _find(handle).ready;
+    }
+
+    void PipelineRegistry::wait(const Handle handle) const {
+        std::shared_future<void> compiled;
+        {
+            std::lock_guard lock(_mutex);
+            compiled = _find(handle).compiled;
+        }
+
+        if (compiled.valid()) {
+            compiled.get();
+        }
+
+        std::lock_guard lock(_mutex);
+        if (const Entry& entry = _find(handle); entry.error) {
+            std::rethrow_exception(entry.error);
+        }
+    }
+
+    std::vector<PipelineRegistry::Handle> PipelineRegistry::take_completed() {
+        std::lock_guard lock(_mutex);
+        return std::exchange(_completed, {});
+    }
+
+    std::size_t PipelineRegistry::size() const {
+        std::lock_guard lock(_mutex);
+        return _entries.size();
+    }
+
+    void PipelineRegistry::retire(const Handle handle) {
+        std::lock_guard lock(_mutex);
+
+        const auto it = _entries.find(handle);
+        if (it == _entries.end()) {
+            throw std::runtime_error("Pipeline variant has not been requested.");
+        }
+
+        // Requesting the same description again compiles a fresh variant
+        _retired.push_back(RetiredEntry {std::move(it->second), _frame});
+        _entries.erase(it);
+        std::erase(_completed, handle);
+    }
+
+    void PipelineRegistry::end_frame() {
+        std::lock_guard lock(_mutex);
+        ++_frame;
+
+        const std::uint64_t frames_in_flight = std::max<std::size_t>(_context->per_frame.size(), 1);
+        std::erase_if(_retired, [&](const RetiredEntry& retired) {
+            if (_frame - retired.frame < frames_in_flight) {
+                return false;
+            }
+
+            // A variant retired while compiling is kept until its worker is done with it
+            const auto& compiled = retired.entry->compiled;
+            if (compiled.valid() && compiled.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+
+            _destroy(*retired.entry);
+            return true;
+        });
+    }
+
+    PipelineRegistry::Entry* PipelineRegistry::_lookup(const PipelineDescription& description, Handle& handle) const {
+        // Different descriptions can share a hash, the later one then takes the next free handle
+        for (handle = description.hash();; ++handle) {
+            const auto it = _entries.find(handle);
+            if (it == _entries.end()) {
+                return nullptr;
+            }
+
+            if (it->second->description == description) {
+                return it->second.get();
+            }
+        }
+    }
+
+    void PipelineRegistry::_validate(const PipelineDescription& description) {
+        const bool hashed = std::ranges::all_of(description.stages, [](const PipelineStage& stage) { return stage.code_hash != 0; });
+        if (!hashed) {
+            throw std::runtime_error("Pipeline stages registered with a PipelineRegistry need a code hash (see Shader::get_code_hash).");
+        }
+    }
+
+    PipelineRegistry::Entry& PipelineRegistry::_insert(const Handle handle, const PipelineDescription& description) {
+        // The layout is cheap to create, only the pipeline itself is compiled off the calling thread
+        auto entry = std::make_unique<Entry>();
+        entry->description = description;
+        entry->variant.layout = GraphicsPipeline::create_pipeline_layout(*_context, description);
+
+        return *_entries.emplace(handle, std::move(entry)).first->second;
+    }
+
+    void PipelineRegistry::_compile(Entry& entry, const Handle handle, const PipelineDescription& description) {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        std::exception_ptr error;
+
+        try {
+            pipeline = GraphicsPipeline::create_pipeline(*_context, description, entry.variant.layout);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard lock(_mutex);
+        entry.variant.pipeline = pipeline;
+        entry.error = error;
+        entry.ready = error == nullptr;
+
+        if (entry.ready) {
+            _completed.push_back(handle);
+        }
+    }
+
+    const PipelineRegistry::Entry& PipelineRegistry::_find(const Handle handle) const {
+        const auto it = _entries.find(handle);
+        if (it == _entries.end()) {
+            throw std::runtime_error("Pipeline variant has not been requested.");
+        }
+
+        return *it->second;
+    }
+
+    void PipelineRegistry::_destroy(Entry& entry) const {
+        vkDestroyPipeline(_context->device, entry.variant.pipeline, nullptr);
+        vkDestroyPipelineLayout(_context->device, entry.variant.layout, nullptr);
+    }
+}  // namespace fr
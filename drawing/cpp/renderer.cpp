@@ -1,4 +1,5 @@
 #include "renderer.h"
+#include "descriptor_allocator.h"
 #include "descriptor_set_types.h"
 #include "utils/error.h"
 #include "utils/image_utils.h"
@@ -11,87 +12,145 @@ namespace fr {
     { }
 
     void Renderer::build_command_buffers(const RendererParams& renderer_params) {
-        VkCommandBufferBeginInfo begin_info {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
-        };
+        _validate_params(renderer_params);
 
         for (std::size_t frame = 0; frame < _context->per_frame.size(); ++frame) {
             vkWaitForFences(_context->device, 1, &_context->per_frame[frame].queue_submit_fence, VK_TRUE, UINT64_MAX);
+            _record_command_buffer(frame, renderer_params);
+        }
 
-            // Begin command buffer recording
-            validate(
-                vkBeginCommandBuffer(_context->per_frame[frame].primary_command_buffer, &begin_info),
-                "Failed to start recording command buffer."
-            );
+        _stale_frames.assign(_context->per_frame.size(), false);
+    }
 
-            // transition the image to the COLOR_ATTACHMENT_OPTIMAL for drawing
-            image::transition_layout(
-                _context->per_frame[frame].primary_command_buffer,
-                _context->swap_chain_images[frame],
-                VK_IMAGE_LAYOUT_UNDEFINED,
-                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                VK_IMAGE_ASPECT_COLOR_BIT,
-                0,                                                     // srcAccessMask (no need to wait for previous operations)
-                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,                // dstAccessMask
-                VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,                   // srcStage
-                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT        // dstStage
-            );
+    void Renderer::update_command_buffers(const RendererParams& renderer_params) {
+        _validate_params(renderer_params);
 
-            image::transition_layout(
-                _context->per_frame[frame].primary_command_buffer,
-                _context->depth_image,
-                VK_IMAGE_LAYOUT_UNDEFINED,
-                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT,
-                0,
-                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
-            );
+        // Nothing waits here: draw() re-records each frame right after waiting on that frame's own fence
+        _pending_params = renderer_params;
+        _stale_frames.assign(_context->per_frame.size(), true);
+    }
 
-            // Set clear color values.
-            const VkClearValue clear_value {
-                .color = {{0.01f, 0.01f, 0.033f, 1.0f}}
-            };
+    void Renderer::_validate_params(const RendererParams& renderer_params) const {
+        if (renderer_params.push_descriptors != nullptr && (renderer_params.push_descriptor_set == 0 ||
+            (renderer_params.push_descriptor_set == 1 && renderer_params.bindless_descriptor != VK_NULL_HANDLE))) {
+            throw std::runtime_error("Push descriptors must use a set that is not bound to another descriptor set.");
+        }
 
-            // Set up the rendering attachment info
-            VkRenderingAttachmentInfo color_attachment {
-                .sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
-                .imageView   = _context->swap_chain_image_views[frame],
-                .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                .loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR,
-                .storeOp     = VK_ATTACHMENT_STORE_OP_STORE,
-                .clearValue  = clear_value
-            };
+        // Pipelines created for descriptor buffers can't have descriptor sets bound
+        if (renderer_params.descriptor_buffer != nullptr && renderer_params.bindless_descriptor != VK_NULL_HANDLE) {
+            throw std::runtime_error("The bindless descriptor set cannot be bound together with a descriptor buffer.");
+        }
 
-            VkRenderingAttachmentInfo depth_attachment {
-                .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
-                .imageView = _context->depth_image_view,
-                .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                .loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR,
-                .storeOp     = VK_ATTACHMENT_STORE_OP_STORE,
-                .clearValue  = {1.0f, 0}
-            };
+        // Pushing next to a descriptor buffer needs VK_BUFFER_USAGE_PUSH_DESCRIPTORS_DESCRIPTOR_BUFFER_BIT_EXT on the
+        //      buffer when bufferlessPushDescriptors is not supported, which DescriptorBuffer does not set
+        if (renderer_params.descriptor_buffer != nullptr && renderer_params.push_descriptors != nullptr) {
+            throw std::runtime_error("Push descriptors cannot be used together with a descriptor buffer.");
+        }
+    }
 
-            // Begin rendering
-            VkRenderingInfo rendering_info {
-                .sType                = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
-                .renderArea           = {    // Initialize the nested `VkRect2D` structure
-                    .offset = {0, 0},        // Initialize the `VkOffset2D` inside `renderArea`
-                    .extent = {              // Initialize the `VkExtent2D` inside `renderArea`
-                        .width  = _context->swap_chain_dimensions.width,
-                        .height = _context->swap_chain_dimensions.height}
-                },
-            .layerCount = 1,
-            .colorAttachmentCount = 1,
-            .pColorAttachments    = &color_attachment,
-            .pDepthAttachment     = &depth_attachment
+    void Renderer::_record_command_buffer(const std::size_t frame, const RendererParams& renderer_params) {
+        VkCommandBufferBeginInfo begin_info {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
         };
 
-            vkCmdBeginRendering(_context->per_frame[frame].primary_command_buffer, &rendering_info);
+        VkPipeline pipeline = _context->pipeline;
+        VkPipelineLayout pipeline_layout = _context->pipeline_layout;
+        if (renderer_params.pipeline_registry != nullptr) {
+            const auto variant = renderer_params.pipeline_registry->resolve(renderer_params.pipeline_variant, renderer_params.fallback_variant);
+
+            pipeline        = variant.has_value() ? variant->pipeline : VK_NULL_HANDLE;
+            pipeline_layout = variant.has_value() ? variant->layout : VK_NULL_HANDLE;
+        }
+        if (renderer_params.shader_objects != nullptr) {
+            pipeline_layout = renderer_params.shader_objects->get_layout();
+        }
+
+        // Begin command buffer recording
+        validate(
+            vkBeginCommandBuffer(_context->per_frame[frame].primary_command_buffer, &begin_info),
+            "Failed to start recording command buffer."
+        );
+
+        // transition the image to the COLOR_ATTACHMENT_OPTIMAL for drawing
+        image::transition_layout(
+            _context->per_frame[frame].primary_command_buffer,
+            _context->swap_chain_images[frame],
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,                                                     // srcAccessMask (no need to wait for previous operations)
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,                // dstAccessMask
+            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,                   // srcStage
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT        // dstStage
+        );
+
+        image::transition_layout(
+            _context->per_frame[frame].primary_command_buffer,
+            _context->depth_image,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT,
+            0,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT
+        );
 
+        // Set clear color values.
+        const VkClearValue clear_value {
+            .color = {{0.01f, 0.01f, 0.033f, 1.0f}}
+        };
+
+        // Set up the rendering attachment info
+        VkRenderingAttachmentInfo color_attachment {
+            .sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView   = _context->swap_chain_image_views[frame],
+            .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp     = VK_ATTACHMENT_STORE_OP_STORE,
+            .clearValue  = clear_value
+        };
+
+        VkRenderingAttachmentInfo depth_attachment {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView = _context->depth_image_view,
+            .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .loadOp      = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp     = VK_ATTACHMENT_STORE_OP_STORE,
+            .clearValue  = {1.0f, 0}
+        };
+
+        // Begin rendering
+        VkRenderingInfo rendering_info {
+            .sType                = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+            .renderArea           = {    // Initialize the nested `VkRect2D` structure
+                .offset = {0, 0},        // Initialize the `VkOffset2D` inside `renderArea`
+                .extent = {              // Initialize the `VkExtent2D` inside `renderArea`
+                    .width  = _context->swap_chain_dimensions.width,
+                    .height = _context->swap_chain_dimensions.height}
+            },
+        .layerCount = 1,
+        .colorAttachmentCount = 1,
+        .pColorAttachments    = &color_attachment,
+        .pDepthAttachment     = &depth_attachment
+    };
+
+        vkCmdBeginRendering(_context->per_frame[frame].primary_command_buffer, &rendering_info);
+
+        // A variant that is still compiling (with no fallback ready) is skipped, the pass still clears
+        if (renderer_params.shader_objects != nullptr) {
+            // Shader objects have no baked state, all of it is recorded here
+            DynamicGraphicsState state = renderer_params.shader_object_state;
+            state.polygon_mode = renderer_params.polygon_mode;
+
+            renderer_params.shader_objects->bind(_context->per_frame[frame].primary_command_buffer);
+            renderer_params.shader_objects->set_state(_context->per_frame[frame].primary_command_buffer, state, VkExtent2D {
+                .width  = _context->swap_chain_dimensions.width,
+                .height = _context->swap_chain_dimensions.height
+            });
+        } else if (pipeline != VK_NULL_HANDLE) {
             // bind the graphics pipeline
-            vkCmdBindPipeline(_context->per_frame[frame].primary_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _context->pipeline);
+            vkCmdBindPipeline(_context->per_frame[frame].primary_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
             // Set the dynamic states (defined in the pipeline creation)
             VkViewport vp {
@@ -115,7 +174,9 @@ namespace fr {
             vkCmdSetPrimitiveTopology(_context->per_frame[frame].primary_command_buffer, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
 
             _context->extensions.polygon_mode(_context->per_frame[frame].primary_command_buffer, renderer_params.polygon_mode);
+        }
 
+        if (renderer_params.shader_objects != nullptr || pipeline != VK_NULL_HANDLE) {
             VkDeviceSize offset = {0};
             vkCmdBindVertexBuffers(_context->per_frame[frame].primary_command_buffer, 0, 1, &_context->vertex_buffer.buffer, &offset);
             vkCmdBindIndexBuffer(_context->per_frame[frame].primary_command_buffer, _context->indices_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
@@ -124,31 +185,74 @@ namespace fr {
                 vkCmdBindVertexBuffers(_context->per_frame[frame].primary_command_buffer, 1, 1, &_context->instance_buffer.buffer, &offset);
             }
 
-            vkCmdBindDescriptorSets(_context->per_frame[frame].primary_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _context->pipeline_layout, 0, 1, &_context->descriptor.descriptor, 0, nullptr);
+            if (renderer_params.descriptor_buffer != nullptr) {
+                renderer_params.descriptor_buffer->bind(_context->per_frame[frame].primary_command_buffer);
+                renderer_params.descriptor_buffer->bind_slot(_context->per_frame[frame].primary_command_buffer, pipeline_layout, 0, renderer_params.descriptor_buffer_slot);
+            } else {
+                vkCmdBindDescriptorSets(_context->per_frame[frame].primary_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &_context->descriptor.descriptor, 0, nullptr);
+            }
+
+            if (renderer_params.bindless_descriptor != VK_NULL_HANDLE) {
+                vkCmdBindDescriptorSets(_context->per_frame[frame].primary_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 1, 1, &renderer_params.bindless_descriptor, 0, nullptr);
+            }
+
+            if (renderer_params.push_descriptors != nullptr) {
+                push_descriptors(_context->per_frame[frame].primary_command_buffer, renderer_params.push_descriptor_set, *renderer_params.push_descriptors, pipeline_layout);
+            }
+
+            if (renderer_params.push_constants != nullptr) {
+                vkCmdPushConstants(
+                    _context->per_frame[frame].primary_command_buffer,
+                    pipeline_layout,
+                    renderer_params.push_constant_stages,
+                    0,
+                    renderer_params.push_constants_size,
+                    renderer_params.push_constants
+                );
+            }
 
             vkCmdDrawIndexed(_context->per_frame[frame].primary_command_buffer, _context->indices_buffer.count, _context->instance_count, 0, 0, 0);
+        }
 
-            // Complete rendering
-            vkCmdEndRendering(_context->per_frame[frame].primary_command_buffer);
-
-            // After rendering, transition to the PRESENT_SRC layout
-            image::transition_layout(
-                _context->per_frame[frame].primary_command_buffer,
-                _context->swap_chain_images[frame],
-                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                VK_IMAGE_ASPECT_COLOR_BIT,
-                VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,                   // srcAccessMask
-                0,                                                        // dstAccessMask
-                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,          // srcStage
-                VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT                    // dstStage
-            );
+        // Complete rendering
+        vkCmdEndRendering(_context->per_frame[frame].primary_command_buffer);
+
+        // After rendering, transition to the PRESENT_SRC layout
+        image::transition_layout(
+            _context->per_frame[frame].primary_command_buffer,
+            _context->swap_chain_images[frame],
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,                   // srcAccessMask
+            0,                                                        // dstAccessMask
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,          // srcStage
+            VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT                    // dstStage
+        );
 
-            validate(
-                vkEndCommandBuffer(_context->per_frame[frame].primary_command_buffer),
-                "Failed to complete the command buffer."
-            );
+        validate(
+            vkEndCommandBuffer(_context->per_frame[frame].primary_command_buffer),
+            "Failed to complete the command buffer."
+        );
+    }
+
+    void Renderer::push_descriptors(VkCommandBuffer command_buffer, const std::uint32_t set, std::vector<DescriptorInfo>& info, VkPipelineLayout pipeline_layout) {
+        if (!_context->features.push_descriptor) {
+            throw std::runtime_error("Push descriptors are not supported by the device.");
         }
+
+        // dstSet is ignored for pushed writes
+        auto descriptor_set = DescriptorSet(_context);
+        const auto writes = descriptor_set.create_descriptor_writes(VK_NULL_HANDLE, info);
+
+        _context->extensions.push_descriptor_set(
+            command_buffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipeline_layout != VK_NULL_HANDLE ? pipeline_layout : _context->pipeline_layout,
+            set,
+            static_cast<std::uint32_t>(writes.size()),
+            writes.data()
+        );
     }
 
     bool Renderer::draw() {
@@ -165,6 +269,12 @@ namespace fr {
             throw std::runtime_error("Failed to present swap chain image.");
         }
 
+        // The frame's fence has signalled, so a command buffer invalidated by update_command_buffers() can be re-recorded
+        if (index < _stale_frames.size() && _stale_frames[index]) {
+            _record_command_buffer(index, *_pending_params);
+            _stale_frames[index] = false;
+        }
+
         // Submit it to the queue with a release semaphore.
         if (_context->per_frame[index].swap_chain_release_semaphore == VK_NULL_HANDLE) {
             VkSemaphoreCreateInfo semaphore_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
@@ -237,6 +347,7 @@ namespace fr {
         if (_context->per_frame[*image].queue_submit_fence != VK_NULL_HANDLE) {
             vkWaitForFences(_context->device, 1, &_context->per_frame[*image].queue_submit_fence, true, UINT64_MAX);
             vkResetFences(_context->device, 1, &_context->per_frame[*image].queue_submit_fence);
+            _context->per_frame[*image].descriptor_allocator->reset();
         }
 
         VkSemaphore old_semaphore = _context->per_frame[*image].swap_chain_acquire_semaphore;
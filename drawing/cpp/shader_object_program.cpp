@@ -0,0 +1,172 @@
+#include "shader_object_program.h"
+#include "utils/error.h"
+
+#include <array>
+#include <stdexcept>
+
+namespace fr {
+    ShaderObjectProgram::ShaderObjectProgram(
+        const std::shared_ptr<VkContext>& context,
+        const std::span<const std::uint32_t> code,
+        const std::vector<VkDescriptorSetLayout>& set_layouts,
+        const std::vector<VkPushConstantRange>& push_constant_ranges,
+        const SpecializationConstants& specialization
+    )
+        : _context(context)
+    {
+        if (!_context->features.shader_object) {
+            throw std::runtime_error("Shader objects are not supported by the device.");
+        }
+
+        const VkSpecializationInfo specialization_info = specialization.get_info();
+
+        VkShaderCreateInfoEXT shader_template {
+            .sType                  = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+            .flags                  = VK_SHADER_CREATE_LINK_STAGE_BIT_EXT,
+            .codeType               = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+            .codeSize               = code.size_bytes(),
+            .pCode                  = code.data(),
+            .setLayoutCount         = static_cast<std::uint32_t>(set_layouts.size()),
+            .pSetLayouts            = set_layouts.data(),
+            .pushConstantRangeCount = static_cast<std::uint32_t>(push_constant_ranges.size()),
+            .pPushConstantRanges    = push_constant_ranges.data(),
+            .pSpecializationInfo    = specialization.empty() ? nullptr : &specialization_info
+        };
+
+        // Same entry points as Shader
+        std::array<VkShaderCreateInfoEXT, 2> shader_infos = {shader_template, shader_template};
+        shader_infos[0].stage     = VK_SHADER_STAGE_VERTEX_BIT;
+        shader_infos[0].nextStage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        shader_infos[0].pName     = "vertex_main";
+        shader_infos[1].stage     = VK_SHADER_STAGE_FRAGMENT_BIT;
+        shader_infos[1].pName     = "fragment_main";
+
+        std::array<VkShaderEXT, 2> shaders {};
+        validate(
+            _context->extensions.create_shaders(_context->device, static_cast<std::uint32_t>(shader_infos.size()), shader_infos.data(), nullptr, shaders.data()),
+            "Failed to create shader objects."
+        );
+        _vertex_shader   = shaders[0];
+        _fragment_shader = shaders[1];
+
+        // Descriptor sets and push constants are still bound through a layout
+        VkPipelineLayoutCreateInfo layout_info {
+            .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount         = static_cast<std::uint32_t>(set_layouts.size()),
+            .pSetLayouts            = set_layouts.data(),
+            .pushConstantRangeCount = static_cast<std::uint32_t>(push_constant_ranges.size()),
+            .pPushConstantRanges    = push_constant_ranges.data()
+        };
+
+        validate(
+            vkCreatePipelineLayout(_context->device, &layout_info, nullptr, &_layout),
+            "Failed to create shader object pipeline layout."
+        );
+    }
+
+    ShaderObjectProgram::~ShaderObjectProgram() {
+        vkDestroyPipelineLayout(_context->device, _layout, nullptr);
+        _context->extensions.destroy_shader(_context->device, _fragment_shader, nullptr);
+        _context->extensions.destroy_shader(_context->device, _vertex_shader, nullptr);
+    }
+
+    void ShaderObjectProgram::bind(VkCommandBuffer command_buffer) const {
+        constexpr std::array<VkShaderStageFlagBits, 2> stages = {VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT};
+        const std::array<VkShaderEXT, 2> shaders = {_vertex_shader, _fragment_shader};
+
+        _context->extensions.bind_shaders(command_buffer, static_cast<std::uint32_t>(stages.size()), stages.data(), shaders.data());
+    }
+
+    void ShaderObjectProgram::set_state(VkCommandBuffer command_buffer, const DynamicGraphicsState& state, const VkExtent2D extent) const {
+        const Extensions& extensions = _context->extensions;
+
+        // Viewport and scissor
+        const VkViewport viewport {
+            .width    = static_cast<float>(extent.width),
+            .height   = static_cast<float>(extent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f
+        };
+        const VkRect2D scissor {
+            .extent = extent
+        };
+        vkCmdSetViewportWithCount(command_buffer, 1, &viewport);
+        vkCmdSetScissorWithCount(command_buffer, 1, &scissor);
+
+        // Vertex input and assembly
+        std::vector<VkVertexInputBindingDescription2EXT> bindings;
+        bindings.reserve(state.vertex_info.binding_description.size());
+        for (const auto& binding : state.vertex_info.binding_description) {
+            bindings.push_back(VkVertexInputBindingDescription2EXT {
+                .sType     = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT,
+                .binding   = binding.binding,
+                .stride    = binding.stride,
+                .inputRate = binding.inputRate,
+                .divisor   = 1
+            });
+        }
+
+        std::vector<VkVertexInputAttributeDescription2EXT> attributes;
+        attributes.reserve(state.vertex_info.attribute_descriptions.size());
+        for (const auto& attribute : state.vertex_info.attribute_descriptions) {
+            attributes.push_back(VkVertexInputAttributeDescription2EXT {
+                .sType    = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT,
+                .location = attribute.location,
+                .binding  = attribute.binding,
+                .format   = attribute.format,
+                .offset   = attribute.offset
+            });
+        }
+
+        extensions.set_vertex_input(
+            command_buffer,
+            static_cast<std::uint32_t>(bindings.size()),
+            bindings.data(),
+            static_cast<std::uint32_t>(attributes.size()),
+            attributes.data()
+        );
+        vkCmdSetPrimitiveTopology(command_buffer, state.topology);
+        vkCmdSetPrimitiveRestartEnable(command_buffer, VK_FALSE);
+
+        // Rasterisation
+        vkCmdSetRasterizerDiscardEnable(command_buffer, VK_FALSE);
+        extensions.polygon_mode(command_buffer, state.polygon_mode);
+        vkCmdSetCullMode(command_buffer, state.cull_mode);
+        vkCmdSetFrontFace(command_buffer, state.front_face);
+        vkCmdSetLineWidth(command_buffer, 1.0f);
+        vkCmdSetDepthBiasEnable(command_buffer, VK_FALSE);
+
+        // No multisampling
+        constexpr VkSampleMask sample_mask = ~0u;
+        extensions.set_rasterization_samples(command_buffer, VK_SAMPLE_COUNT_1_BIT);
+        extensions.set_sample_mask(command_buffer, VK_SAMPLE_COUNT_1_BIT, &sample_mask);
+        extensions.set_alpha_to_coverage_enable(command_buffer, VK_FALSE);
+
+        // Depth and stencil
+        vkCmdSetDepthTestEnable(command_buffer, state.depth_test ? VK_TRUE : VK_FALSE);
+        vkCmdSetDepthWriteEnable(command_buffer, state.depth_write ? VK_TRUE : VK_FALSE);
+        vkCmdSetDepthCompareOp(command_buffer, state.depth_compare_op);
+        vkCmdSetDepthBoundsTestEnable(command_buffer, VK_FALSE);
+        vkCmdSetStencilTestEnable(command_buffer, VK_FALSE);
+
+        // Blending, matching GraphicsPipeline
+        const VkBool32 blend_enable = state.alpha_blend ? VK_TRUE : VK_FALSE;
+        const VkColorBlendEquationEXT blend_equation {
+            .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+            .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+            .colorBlendOp        = VK_BLEND_OP_ADD,
+            .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+            .dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+            .alphaBlendOp        = VK_BLEND_OP_ADD
+        };
+        constexpr VkColorComponentFlags write_mask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        extensions.set_color_blend_enable(command_buffer, 0, 1, &blend_enable);
+        extensions.set_color_blend_equation(command_buffer, 0, 1, &blend_equation);
+        extensions.set_color_write_mask(command_buffer, 0, 1, &write_mask);
+    }
+
+    VkPipelineLayout ShaderObjectProgram::get_layout() const {
+        return _layout;
+    }
+}  // namespace fr
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace fr {
+    /// Set layouts are identified by their create flags and bindings; immutable samplers are not supported
+    struct DescriptorLayoutKey {
+        VkDescriptorSetLayoutCreateFlags flags = 0;
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+
+        bool operator==(const DescriptorLayoutKey& other) const;
+    };
+
+    struct DescriptorLayoutKeyHash {
+        std::size_t operator()(const DescriptorLayoutKey& key) const;
+    };
+
+    /// Creates each distinct descriptor set layout once. Layouts live as long as the cache. Thread safe.
+    class DescriptorLayoutCache {
+    public:
+        explicit DescriptorLayoutCache(VkDevice device);
+
+        ~DescriptorLayoutCache();
+
+        DescriptorLayoutCache(const DescriptorLayoutCache&) = delete;
+        DescriptorLayoutCache& operator=(const DescriptorLayoutCache&) = delete;
+
+        /// Bindings may be given in any order
+        VkDescriptorSetLayout get(std::vector<VkDescriptorSetLayoutBinding> bindings, VkDescriptorSetLayoutCreateFlags flags = 0);
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        VkDevice _device;
+        mutable std::mutex _mutex;
+        std::unordered_map<DescriptorLayoutKey, VkDescriptorSetLayout, DescriptorLayoutKeyHash> _layouts;
+    };
+
+    /*
+     *  Allocates descriptor sets from a chain of pools.
+     *
+     *  When a pool runs out (VK_ERROR_OUT_OF_POOL_MEMORY / VK_ERROR_FRAGMENTED_POOL) it is retired and the allocation
+     *      retried from a fresh or recycled pool, each new pool holding more sets than the last. Sets are never freed
+     *      one by one: reset() returns every pool at once, which is how per-frame allocators are recycled.
+     *  Thread safe.
+     */
+    class DescriptorAllocator {
+    public:
+        /// Descriptors of a type per set, used to size each pool. Layouts may only use types listed in the ratios.
+        struct PoolRatio {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        static const std::vector<PoolRatio> default_ratios;
+
+        explicit DescriptorAllocator(
+            VkDevice device,
+            std::uint32_t initial_sets = 64,
+            std::vector<PoolRatio> ratios = default_ratios,
+            VkDescriptorPoolCreateFlags pool_flags = 0
+        );
+
+        ~DescriptorAllocator();
+
+        DescriptorAllocator(const DescriptorAllocator&) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+        /// next is chained into VkDescriptorSetAllocateInfo (e.g. variable descriptor counts)
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout, const void* next = nullptr);
+
+        /// Releases every set allocated so far. The caller must ensure none of them is still in use by the GPU.
+        void reset();
+
+        [[nodiscard]] std::size_t pool_count() const;
+
+    private:
+        static constexpr std::uint32_t max_sets_per_pool = 4096;
+
+        VkDevice _device;
+        std::uint32_t _sets_per_pool;
+        std::vector<PoolRatio> _ratios;
+        VkDescriptorPoolCreateFlags _pool_flags;
+        mutable std::mutex _mutex;
+        VkDescriptorPool _current_pool = VK_NULL_HANDLE;
+        bool _current_pool_used = false;  // An empty pool that fails an allocation is never retired
+        std::vector<VkDescriptorPool> _ready_pools;  // Reset pools waiting to be reused
+        std::vector<VkDescriptorPool> _full_pools;
+
+        VkDescriptorPool _next_pool();
+
+        VkDescriptorPool _create_pool(std::uint32_t max_sets) const;
+    };
+}  // namespace fr
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "descriptor_set.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace fr {
+    /*
+     *  A descriptor-buffer alternative to pools and sets (VK_EXT_descriptor_buffer).
+     *
+     *  The buffer holds `capacity` slots, each laid out like one set of the layout built from a DescriptorInfo list.
+     *      write() turns DescriptorInfos into descriptor bytes with vkGetDescriptorEXT straight into mapped memory, so
+     *      slots can be filled from worker threads. Draws select a slot by offset instead of binding a set:
+     *          descriptor_buffer.bind(cmd);
+     *          descriptor_buffer.bind_slot(cmd, pipeline_layout, 0, slot);
+     *
+     *  Pipelines drawing with it must be created with descriptor_buffer = true (see GraphicsPipeline::create_pipeline),
+     *      which rules out binding descriptor sets other than push descriptors. Buffers referenced by the descriptors
+     *      must have been created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT.
+     *  Released slots are only handed out again after end_frame() has been called once per frame in flight.
+     *  Requires VkContext::features.descriptor_buffer.
+     */
+    class DescriptorBuffer {
+    public:
+        DescriptorBuffer(const std::shared_ptr<VkContext>& context, const std::vector<DescriptorInfo>& info, std::uint32_t capacity);
+
+        ~DescriptorBuffer();
+
+        DescriptorBuffer(const DescriptorBuffer&) = delete;
+        DescriptorBuffer& operator=(const DescriptorBuffer&) = delete;
+
+        /// Returns a free slot. Throws when the buffer is full.
+        std::uint32_t allocate();
+
+        /// Writes every binding of info into slot. Thread safe for distinct slots.
+        void write(std::uint32_t slot, const std::vector<DescriptorInfo>& info);
+
+        /// Frees a slot. Shaders must no longer read it from frames recorded after this call.
+        void release(std::uint32_t slot);
+
+        /// Advances the frame counter, recycling slots released per_frame.size() frames ago
+        void end_frame();
+
+        /// Binds the buffer as descriptor buffer 0 of command_buffer
+        void bind(VkCommandBuffer command_buffer) const;
+
+        /// Points set `set` of pipeline_layout at slot
+        void bind_slot(VkCommandBuffer command_buffer, VkPipelineLayout pipeline_layout, std::uint32_t set, std::uint32_t slot) const;
+
+        [[nodiscard]] VkDescriptorSetLayout get_layout() const;
+
+        [[nodiscard]] std::uint32_t get_capacity() const;
+
+        [[nodiscard]] VkDeviceSize get_slot_size() const;
+
+    private:
+        struct Binding {
+            std::uint32_t binding;
+            VkDescriptorType type;
+            VkDeviceSize offset;  // Within a slot
+            std::size_t size;     // Descriptor size for type
+        };
+
+        struct RetiredSlot {
+            std::uint32_t slot;
+            std::uint64_t frame;
+        };
+
+        std::shared_ptr<VkContext> _context;
+        VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+        BufferCore _buffer;
+        VkBufferUsageFlags _usage = 0;
+        std::uint8_t* _mapped = nullptr;
+        VkDeviceSize _slot_size = 0;
+        std::uint32_t _capacity = 0;
+        std::vector<Binding> _bindings;
+
+        std::mutex _mutex;
+        std::uint64_t _frame = 0;
+        std::vector<std::uint32_t> _free_slots;
+        std::vector<RetiredSlot> _retired_slots;
+        std::vector<bool> _allocated;
+
+        void _create_layout(const std::vector<DescriptorInfo>& info);
+
+        void _create_buffer();
+
+        void _write_descriptor(const Binding& binding, const DescriptorInfo& info, std::uint8_t* destination) const;
+
+        [[nodiscard]] const Binding& _find_binding(std::uint32_t binding) const;
+
+        void _validate_slot(std::uint32_t slot) const;
+    };
+}  // namespace fr
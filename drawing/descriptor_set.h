@@ -43,13 +43,20 @@ namespace fr {
 
         void create_descriptor_sets(DescriptorCore& core, std::vector<DescriptorInfo>& info);
 
-        VkDescriptorSetLayoutBinding create_descriptor_layout(VkDescriptorType type, VkShaderStageFlags flags, std::uint32_t binding);
+        /// Allocates and writes a set from the given allocator, e.g. a PerFrame one for sets that only live for a frame.
+        ///     The set is written through a DescriptorTemplate; info must not repeat a binding.
+        VkDescriptorSet allocate_descriptor_set(std::vector<DescriptorInfo>& info, DescriptorAllocator& allocator);
+
+        /// The cached layout matching the bindings in info
+        VkDescriptorSetLayout get_descriptor_layout(const std::vector<DescriptorInfo>& info, VkDescriptorSetLayoutCreateFlags flags = 0);
 
-        void set_descriptor_layout(VkDescriptorSetLayout& descriptor_set_layout, std::vector<VkDescriptorSetLayoutBinding>& layout_bindings);
+        /// A layout whose set is pushed with Renderer::push_descriptors instead of allocated. Requires VkContext::features.push_descriptor.
+        VkDescriptorSetLayout get_push_descriptor_layout(const std::vector<DescriptorInfo>& info);
 
-        VkDescriptorPoolSize create_descriptor_pool(VkDescriptorType type, std::uint32_t pool_size);
+        /// One write per binding in info; the writes point into info, which must outlive them
+        std::vector<VkWriteDescriptorSet> create_descriptor_writes(VkDescriptorSet descriptor_set, std::vector<DescriptorInfo>& info);
 
-        void set_descriptor_pool(VkDescriptorPool& descriptor_pool, std::vector<VkDescriptorPoolSize>& pool_sizes, std::uint32_t max_sets);
+        VkDescriptorSetLayoutBinding create_descriptor_layout(VkDescriptorType type, VkShaderStageFlags flags, std::uint32_t binding);
 
         VkWriteDescriptorSet create_descriptor_set(VkDescriptorSet& descriptor_set, VkDescriptorBufferInfo* buffer_info, VkDescriptorType type, std::uint32_t binding);
 
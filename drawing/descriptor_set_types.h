@@ -5,6 +5,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <stdexcept>
+
 namespace fr {
     struct ViewProj {
         glm::mat4 view;
@@ -29,6 +31,21 @@ namespace fr {
         float d;  // Distance between height indexes
     };
 
+    /// Push constants for shaders that read tile data through buffer device addresses.
+    /// tile_table points at an array of per-tile addresses (see BufferUtils::create_address_table), indexed by instance id.
+    /// Requires Features::buffer_device_address.
+    struct TileAddressPushConstants {
+        VkDeviceAddress tile_table;
+
+        [[nodiscard]] static VkPushConstantRange get_range(const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT) {
+            return VkPushConstantRange {
+                .stageFlags = stages,
+                .offset     = 0,
+                .size       = sizeof(TileAddressPushConstants)
+            };
+        }
+    };
+
     struct FloatArray {
         std::vector<float> data;
 
@@ -37,6 +54,11 @@ namespace fr {
         { }
 
         [[nodiscard]] StorageBufferInfo get_storage_buffer_info(const std::uint32_t instance_size_in, float height_modifier_in, float d_in) const {
+            // The grid shader scales heights by 1 / height_modifier
+            if (height_modifier_in == 0.0f) {
+                throw std::runtime_error("The height modifier must not be 0.");
+            }
+
             return StorageBufferInfo {
                 .size = static_cast<std::uint32_t>(data.size()),
                 .instance_size = instance_size_in,
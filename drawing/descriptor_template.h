@@ -0,0 +1,61 @@
+#pragma once
+
+#include "descriptor_set.h"
+
+#include <span>
+#include <vector>
+
+namespace fr {
+    /// One packed descriptor write. Entries are stored back to back, in binding order.
+    union DescriptorTemplateEntry {
+        VkDescriptorBufferInfo buffer_info;
+        VkDescriptorImageInfo  image_info;
+    };
+
+    /*
+     *  A VkDescriptorUpdateTemplate built from a DescriptorInfo list.
+     *
+     *  Every set sharing the bindings of that list can then be written with a single vkUpdateDescriptorSetWithTemplate
+     *      call over a packed array of DescriptorTemplateEntry, instead of building a VkWriteDescriptorSet per binding.
+     *  The set layout comes from VkContext::descriptor_layout_cache, so it matches DescriptorSet::get_descriptor_layout.
+     */
+    class DescriptorTemplate {
+    public:
+        DescriptorTemplate(const std::shared_ptr<VkContext>& context, const std::vector<DescriptorInfo>& info);
+
+        ~DescriptorTemplate();
+
+        DescriptorTemplate(const DescriptorTemplate&) = delete;
+        DescriptorTemplate& operator=(const DescriptorTemplate&) = delete;
+
+        /// Allocates a set from allocator and writes info into it
+        VkDescriptorSet allocate(DescriptorAllocator& allocator, const std::vector<DescriptorInfo>& info);
+
+        /// info must hold the same bindings, in any order, as the list the template was built from. Not thread safe.
+        void update(VkDescriptorSet descriptor_set, const std::vector<DescriptorInfo>& info);
+
+        /// entries must be packed as by pack(). Thread safe.
+        void update(VkDescriptorSet descriptor_set, std::span<const DescriptorTemplateEntry> entries) const;
+
+        /// Packs info into entries (resized to get_entry_count()) in the order the template expects
+        void pack(const std::vector<DescriptorInfo>& info, std::vector<DescriptorTemplateEntry>& entries) const;
+
+        [[nodiscard]] VkDescriptorSetLayout get_layout() const;
+
+        [[nodiscard]] std::size_t get_entry_count() const;
+
+    private:
+        struct Binding {
+            std::uint32_t binding;
+            VkDescriptorType type;
+        };
+
+        std::shared_ptr<VkContext> _context;
+        VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+        VkDescriptorUpdateTemplate _template = VK_NULL_HANDLE;
+        std::vector<Binding> _bindings;  // Sorted by binding, one per packed entry
+        std::vector<DescriptorTemplateEntry> _entries;  // Scratch for update(set, info)
+
+        [[nodiscard]] static bool _is_image(VkDescriptorType type);
+    };
+}  // namespace fr
@@ -1,18 +1,76 @@
 #pragma once
 
 #include "builders/vulkan_structures.h"
+#include "shaders/specialization_constants.h"
 #include "vertex_types.h"
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
 #include <vulkan/vulkan.h>
 
 namespace fr {
+    struct PipelineStage {
+        VkShaderStageFlagBits stage;
+        VkShaderModule module;
+        std::string entry_point;
+        std::uint64_t code_hash = 0;  // Identifies the module's SPIR-V (see Shader::get_code_hash), required by PipelineRegistry
+        SpecializationConstants specialization;  // Each set of values is a separate variant
+    };
+
+    /// Everything that distinguishes one graphics pipeline from another. Viewport, scissor, cull mode, front face,
+    ///     topology and polygon mode are dynamic and therefore not part of it.
+    struct PipelineDescription {
+        std::vector<PipelineStage> stages;
+        VertexInfo vertex_info;
+        std::vector<VkDescriptorSetLayout> set_layouts;
+        std::vector<VkPushConstantRange> push_constant_ranges;
+        VkFormat color_format = VK_FORMAT_UNDEFINED;
+        VkFormat depth_format = VK_FORMAT_UNDEFINED;
+        bool depth_test = true;
+        bool depth_write = true;
+        VkCompareOp depth_compare_op = VK_COMPARE_OP_LESS;
+        bool alpha_blend = false;
+        VkPipelineCreateFlags flags = 0;
+
+        /// Shader modules are identified by code_hash, never by handle, set layouts by handle (they are unique per
+        ///     signature in the layout cache)
+        [[nodiscard]] std::uint64_t hash() const;
+
+        /// Compares what hash() covers
+        bool operator==(const PipelineDescription& other) const;
+    };
+
     class GraphicsPipeline {
     public:
         explicit GraphicsPipeline(std::shared_ptr<VkContext>& context);
 
-        void create_pipeline(const VertexInfo& vertex_info, std::vector<VkPipelineShaderStageCreateInfo>& shader_stages);
+        void create_pipeline(
+            const VertexInfo& vertex_info,
+            std::vector<VkPipelineShaderStageCreateInfo>& shader_stages,
+            const std::vector<VkPushConstantRange>& push_constant_ranges = {},
+            const std::vector<VkDescriptorSetLayout>& additional_set_layouts = {},  // Bound at set 1 onwards, e.g. a BindlessTextureTable
+            bool descriptor_buffer = false  // Sets come from DescriptorBuffers: additional_set_layouts start at set 0
+        );
+
+        /// The description create_pipeline() compiles, for use with a PipelineRegistry. code_hash identifies the module
+        ///     the stages come from (see Shader::get_code_hash). VK_NULL_HANDLE in additional_set_layouts reserves an
+        ///     unused set index with an empty layout, e.g. {VK_NULL_HANDLE, push_layout} pushes at set 2 without a bindless table.
+        [[nodiscard]] PipelineDescription describe(
+            const VertexInfo& vertex_info,
+            const std::vector<VkPipelineShaderStageCreateInfo>& shader_stages,
+            std::uint64_t code_hash,
+            const std::vector<VkPushConstantRange>& push_constant_ranges = {},
+            const std::vector<VkDescriptorSetLayout>& additional_set_layouts = {},
+            bool descriptor_buffer = false
+        ) const;
+
+        /// Creates the layout for description. Thread safe.
+        static VkPipelineLayout create_pipeline_layout(const VkContext& context, const PipelineDescription& description);
+
+        /// Compiles description against layout through the context's pipeline cache. Thread safe.
+        static VkPipeline create_pipeline(const VkContext& context, const PipelineDescription& description, VkPipelineLayout layout);
 
     private:
         std::shared_ptr<VkContext> _context;
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "graphics_pipeline.h"
+#include "utils/thread_pool.h"
+
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace fr {
+    /*
+     *  Deduplicates graphics pipelines by PipelineDescription and compiles new variants on worker threads. Handles
+     *      are the description's hash(); a description whose hash is taken by a different one gets the next free handle.
+     *
+     *  request() returns immediately; until the variant is compiled, resolve() hands back a fallback variant that is
+     *      ready, or nothing, in which case the draw is skipped for that frame. Compilation goes through the context's
+     *      pipeline cache, so variants seen on a previous run compile quickly.
+     *  Shader modules referenced by a description must stay alive until that variant is ready (see wait()). Every stage
+     *      must carry its code_hash: module handles are reused once destroyed, so they cannot identify a variant.
+     *  Variants live until the registry is destroyed unless retired, e.g. when a reloaded shader replaces them.
+     */
+    class PipelineRegistry {
+    public:
+        using Handle = std::uint64_t;
+
+        struct Variant {
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            VkPipelineLayout layout = VK_NULL_HANDLE;
+        };
+
+        explicit PipelineRegistry(const std::shared_ptr<VkContext>& context, std::size_t n_threads = 2);
+
+        /// Waits for outstanding compilations, then destroys every variant
+        ~PipelineRegistry();
+
+        PipelineRegistry(const PipelineRegistry&) = delete;
+        PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+        /// Queues the variant for compilation unless it is already known
+        Handle request(const PipelineDescription& description);
+
+        /// Compiles the variant on the calling thread if needed
+        Variant require(const PipelineDescription& description);
+
+        /// The variant when compiled, else the fallback when compiled, else nothing. Rethrows compilation errors.
+        [[nodiscard]] std::optional<Variant> resolve(Handle handle, std::optional<Handle> fallback = std::nullopt) const;
+
+        [[nodiscard]] bool is_ready(Handle handle) const;
+
+        /// Blocks until the variant has compiled. Rethrows compilation errors.
+        void wait(Handle handle) const;
+
+        /// Variants that became ready since the last call; command buffers recorded with a fallback should be rebuilt
+        std::vector<Handle> take_completed();
+
+        [[nodiscard]] std::size_t size() const;
+
+        /// Forgets the variant and destroys it once the frames that may still draw with it have completed. Command
+        ///     buffers recorded after this call must not use it.
+        void retire(Handle handle);
+
+        /// Advances the frame counter, destroying variants retired per_frame.size() frames ago
+        void end_frame();
+
+    private:
+        struct Entry {
+            PipelineDescription description;
+            Variant variant;
+            bool ready = false;
+            std::exception_ptr error;
+            std::shared_future<void> compiled;
+        };
+
+        struct RetiredEntry {
+            std::unique_ptr<Entry> entry;
+            std::uint64_t frame;
+        };
+
+        std::shared_ptr<VkContext> _context;
+        mutable std::mutex _mutex;
+        std::unordered_map<Handle, std::unique_ptr<Entry>> _entries;
+        std::vector<Handle> _completed;
+        std::vector<RetiredEntry> _retired;
+        std::uint64_t _frame = 0;
+        ThreadPool _workers;
+
+        /// The entry for description, or nullptr with handle set to the free handle to insert it at
+        [[nodiscard]] Entry* _lookup(const PipelineDescription& description, Handle& handle) const;
+
+        /// Throws when a stage has no code_hash
+        static void _validate(const PipelineDescription& description);
+
+        Entry& _insert(Handle handle, const PipelineDescription& description);
+
+        void _compile(Entry& entry, Handle handle, const PipelineDescription& description);
+
+        [[nodiscard]] const Entry& _find(Handle handle) const;
+
+        void _destroy(Entry& entry) const;
+    };
+}  // namespace fr
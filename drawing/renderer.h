@@ -1,10 +1,48 @@
 #pragma once
 #include "builders/vulkan_structures.h"
+#include "descriptor_buffer.h"
+#include "pipeline_registry.h"
+#include "shader_object_program.h"
+
+#include <optional>
+#include <vector>
 
 namespace fr {
     struct RendererParams {
         bool instance = false;  // If using instancing, set this to true.
         VkPolygonMode polygon_mode;
+
+        // Optional push constant data recorded before the draw (e.g. device address tables)
+        const void* push_constants = nullptr;
+        std::uint32_t push_constants_size = 0;
+        VkShaderStageFlags push_constant_stages = VK_SHADER_STAGE_VERTEX_BIT;
+
+        // Optional global texture array bound at set 1 (see BindlessTextureTable)
+        VkDescriptorSet bindless_descriptor = VK_NULL_HANDLE;
+
+        // Optional bindings pushed right before the draw; the pipeline layout must use a push descriptor layout at
+        //      push_descriptor_set (see DescriptorSet::get_push_descriptor_layout). Sets 0 and 1 are taken by the
+        //      context's descriptor set and the bindless table; without a bindless table, reserve set 1 with a
+        //      VK_NULL_HANDLE layout (see GraphicsPipeline::describe).
+        std::vector<DescriptorInfo>* push_descriptors = nullptr;
+        std::uint32_t push_descriptor_set = 2;
+
+        // Optional descriptor buffer whose slot is bound at set 0 in place of the context's descriptor set; the
+        //      pipeline must have been created with descriptor_buffer = true. Descriptor sets cannot be bound next to
+        //      a descriptor buffer, so bindless_descriptor and push_descriptors must stay unset.
+        const DescriptorBuffer* descriptor_buffer = nullptr;
+        std::uint32_t descriptor_buffer_slot = 0;
+
+        // Optional pipeline variant drawn instead of VkContext::pipeline. While it compiles the fallback is drawn if
+        //      ready, otherwise the draw is skipped; rebuild the command buffers once take_completed() reports it.
+        const PipelineRegistry* pipeline_registry = nullptr;
+        PipelineRegistry::Handle pipeline_variant = 0;
+        std::optional<PipelineRegistry::Handle> fallback_variant;
+
+        // Optional shader objects drawn instead of any pipeline, with shader_object_state recorded before the draw
+        //      (polygon_mode above takes precedence over the one in the state)
+        const ShaderObjectProgram* shader_objects = nullptr;
+        DynamicGraphicsState shader_object_state;
     };
 
     class Renderer {
@@ -13,13 +51,27 @@ namespace fr {
 
         void build_command_buffers(const RendererParams& renderer_params);
 
+        /// Marks every frame for re-recording with renderer_params, each one is recorded in draw() after its own
+        ///     fence signals instead of draining the whole GPU like build_command_buffers()
+        void update_command_buffers(const RendererParams& renderer_params);
+
         bool draw();
 
+        /// Records info into command_buffer as set `set` of pipeline_layout (VkContext::pipeline_layout by default),
+        ///     without allocating a descriptor set
+        void push_descriptors(VkCommandBuffer command_buffer, std::uint32_t set, std::vector<DescriptorInfo>& info, VkPipelineLayout pipeline_layout = VK_NULL_HANDLE);
+
         void present_image(std::uint32_t index);
 
     private:
         std::shared_ptr<VkContext> _context;
 
+        std::optional<RendererParams> _pending_params;
+        std::vector<bool> _stale_frames;
+
+        void _validate_params(const RendererParams& renderer_params) const;
+        void _record_command_buffer(std::size_t frame, const RendererParams& renderer_params);
+
         VkResult _acquire_next_swap_chain_image(std::uint32_t* image);
 
         bool _resize();
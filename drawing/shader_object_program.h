@@ -0,0 +1,68 @@
+#pragma once
+
+#include "builders/vulkan_structures.h"
+#include "shaders/specialization_constants.h"
+#include "vertex_info.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace fr {
+    /// Everything a graphics pipeline would have baked in. With shader objects all of it is recorded per draw, so
+    ///     changing any of it costs no compilation.
+    struct DynamicGraphicsState {
+        VertexInfo vertex_info;
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkPolygonMode polygon_mode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags cull_mode = VK_CULL_MODE_NONE;
+        VkFrontFace front_face = VK_FRONT_FACE_CLOCKWISE;
+        bool depth_test = true;
+        bool depth_write = true;
+        VkCompareOp depth_compare_op = VK_COMPARE_OP_LESS;
+        bool alpha_blend = false;
+    };
+
+    /*
+     *  A vertex and fragment shader pair created with VK_EXT_shader_object, the pipeline-free alternative to
+     *      GraphicsPipeline: nothing is compiled per state combination, so there are no permutations to cache and no
+     *      hitches when toggling wireframe, depth modes or vertex formats.
+     *
+     *  Requires Features::shader_object. The two stages are linked, which lets drivers optimise across them as they
+     *      would for a pipeline. Draw with it through RendererParams::shader_objects.
+     */
+    class ShaderObjectProgram {
+    public:
+        /// code holds both entry points (see Shader::get_code); set_layouts and push_constant_ranges must match the
+        ///     descriptor sets and push constants bound when drawing
+        ShaderObjectProgram(
+            const std::shared_ptr<VkContext>& context,
+            std::span<const std::uint32_t> code,
+            const std::vector<VkDescriptorSetLayout>& set_layouts,
+            const std::vector<VkPushConstantRange>& push_constant_ranges = {},
+            const SpecializationConstants& specialization = {}
+        );
+
+        ~ShaderObjectProgram();
+
+        ShaderObjectProgram(const ShaderObjectProgram&) = delete;
+        ShaderObjectProgram& operator=(const ShaderObjectProgram&) = delete;
+
+        void bind(VkCommandBuffer command_buffer) const;
+
+        /// Records every piece of state the bound shaders need for a draw into extent
+        void set_state(VkCommandBuffer command_buffer, const DynamicGraphicsState& state, VkExtent2D extent) const;
+
+        /// For binding descriptor sets and push constants
+        [[nodiscard]] VkPipelineLayout get_layout() const;
+
+    private:
+        std::shared_ptr<VkContext> _context;
+        VkShaderEXT _vertex_shader = VK_NULL_HANDLE;
+        VkShaderEXT _fragment_shader = VK_NULL_HANDLE;
+        VkPipelineLayout _layout = VK_NULL_HANDLE;
+    };
+}  // namespace fr
@@ -1,10 +1,26 @@
 #pragma once
 
+#include "vertex_layout.h"
+
 #include <stdexcept>
-#include <glm/glm.hpp>
+#include <vector>
 
 namespace fr {
     struct VertexInfo {
+        /// The vertex info of a VertexInputLayout, see VertexLayout
+        template<typename... Layouts>
+        static VertexInfo create() {
+            using Input = VertexInputLayout<Layouts...>;
+
+            VertexInfo info {
+                .binding_description    = {Input::bindings.begin(), Input::bindings.end()},
+                .attribute_descriptions = {Input::attributes.begin(), Input::attributes.end()}
+            };
+            info.generate_vertex_info();
+
+            return info;
+        }
+
         std::vector<VkVertexInputBindingDescription> binding_description {};
         std::vector<VkVertexInputAttributeDescription> attribute_descriptions {};
         VkPipelineVertexInputStateCreateInfo vertex_info {};
@@ -34,25 +50,6 @@ namespace fr {
             );
         }
 
-        void add_attribute_description(const glm::vec2& member, const std::uint32_t offset, const std::uint32_t binding) {
-            add_attribute_description(VK_FORMAT_R32G32_SFLOAT, offset, binding);
-        }
-
-        void add_attribute_description(const glm::vec3& member, const std::uint32_t offset, const std::uint32_t binding) {
-            add_attribute_description(VK_FORMAT_R32G32B32_SFLOAT, offset, binding);
-        }
-
-        void add_attribute_description(const std::uint32_t& member, const std::uint32_t offset, const std::uint32_t binding) {
-            add_attribute_description(VK_FORMAT_R32_UINT, offset, binding);
-        }
-
-        void add_attribute_description(const glm::mat4& member, const std::uint32_t offset, const std::uint32_t binding) {
-            add_attribute_description(VK_FORMAT_R32G32B32A32_SFLOAT, offset + sizeof(glm::vec4) * 0, binding);
-            add_attribute_description(VK_FORMAT_R32G32B32A32_SFLOAT, offset + sizeof(glm::vec4) * 1, binding);
-            add_attribute_description(VK_FORMAT_R32G32B32A32_SFLOAT, offset + sizeof(glm::vec4) * 2, binding);
-            add_attribute_description(VK_FORMAT_R32G32B32A32_SFLOAT, offset + sizeof(glm::vec4) * 3, binding);
-        }
-
         void add_binding_description(const std::uint32_t stride, const std::uint32_t binding, VkVertexInputRate input_rate) {
             binding_description.push_back(
                 VkVertexInputBindingDescription {
@@ -62,5 +59,13 @@ namespace fr {
                 }
             );
         }
+
+        /// Appends layout's attributes after the existing locations, reading from binding
+        template<typename Layout>
+        void add_layout(const std::uint32_t binding) {
+            const auto attributes = Layout::attribute_descriptions(binding, static_cast<std::uint32_t>(attribute_descriptions.size()));
+            attribute_descriptions.insert(attribute_descriptions.end(), attributes.begin(), attributes.end());
+            binding_description.push_back(Layout::binding_description(binding));
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+namespace fr {
+    /// Packed attribute types, for vertex data that does not need 32-bit floats. Fill them with pack_half,
+    ///     pack_snorm16, pack_unorm16 and pack_unorm8; the shader reads them as floats (or uints for Uint16x2).
+    struct Half2 { std::uint16_t x, y; };
+    struct Half4 { std::uint16_t x, y, z, w; };
+    struct Snorm16x2 { std::int16_t x, y; };
+    struct Snorm16x4 { std::int16_t x, y, z, w; };
+    struct Unorm16x2 { std::uint16_t x, y; };
+    struct Unorm8x4 { std::uint8_t x, y, z, w; };
+    struct Uint16x2 { std::uint16_t x, y; };
+
+    /// IEEE binary16, rounded to nearest even; out of range values become infinity
+    constexpr std::uint16_t pack_half(const float value) {
+        const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+        const std::uint32_t sign = (bits >> 16) & 0x8000u;
+        const std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+        // Infinity and NaN
+        if (magnitude >= 0x7F800000u) {
+            return static_cast<std::uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x0200u : 0u));
+        }
+
+        // Rounds above 65504
+        if (magnitude >= 0x477FF000u) {
+            return static_cast<std::uint16_t>(sign | 0x7C00u);
+        }
+
+        // Subnormal halves, in units of 2^-24
+        if (magnitude < 0x38800000u) {
+            if (magnitude <= 0x33000000u) {
+                return static_cast<std::uint16_t>(sign);
+            }
+
+            const std::uint32_t mantissa = (magnitude & 0x007FFFFFu) | 0x00800000u;
+            const std::uint32_t shift = 126 - (magnitude >> 23);
+            const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+            const std::uint32_t halfway = 1u << (shift - 1);
+
+            std::uint32_t half = mantissa >> shift;
+            if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+                ++half;
+            }
+
+            return static_cast<std::uint16_t>(sign | half);
+        }
+
+        // Rebias the exponent from 127 to 15, a mantissa carry correctly rolls into the exponent
+        std::uint32_t half = (magnitude - 0x38000000u) >> 13;
+        const std::uint32_t remainder = magnitude & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+            ++half;
+        }
+
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    /// [-1, 1] to [-32767, 32767]
+    constexpr std::int16_t pack_snorm16(const float value) {
+        const float scaled = std::clamp(value, -1.0f, 1.0f) * 32767.0f;
+        return static_cast<std::int16_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+    }
+
+    /// [0, 1] to [0, 65535]
+    constexpr std::uint16_t pack_unorm16(const float value) {
+        return static_cast<std::uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+    }
+
+    /// [0, 1] to [0, 255]
+    constexpr std::uint8_t pack_unorm8(const float value) {
+        return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    /// Format of a vertex attribute type, and the number of locations it takes (one per matrix column)
+    template<typename T>
+    struct VertexFormat;
+
+    template<VkFormat Format, std::uint32_t Locations = 1>
+    struct VertexFormatInfo {
+        static constexpr VkFormat format = Format;
+        static constexpr std::uint32_t locations = Locations;
+    };
+
+    template<> struct VertexFormat<float> : VertexFormatInfo<VK_FORMAT_R32_SFLOAT> { };
+    template<> struct VertexFormat<glm::vec2> : VertexFormatInfo<VK_FORMAT_R32G32_SFLOAT> { };
+    template<> struct VertexFormat<glm::vec3> : VertexFormatInfo<VK_FORMAT_R32G32B32_SFLOAT> { };
+    template<> struct VertexFormat<glm::vec4> : VertexFormatInfo<VK_FORMAT_R32G32B32A32_SFLOAT> { };
+    template<> struct VertexFormat<glm::mat4> : VertexFormatInfo<VK_FORMAT_R32G32B32A32_SFLOAT, 4> { };
+    template<> struct VertexFormat<std::uint32_t> : VertexFormatInfo<VK_FORMAT_R32_UINT> { };
+    template<> struct VertexFormat<std::uint16_t> : VertexFormatInfo<VK_FORMAT_R16_UINT> { };
+    template<> struct VertexFormat<Half2> : VertexFormatInfo<VK_FORMAT_R16G16_SFLOAT> { };
+    template<> struct VertexFormat<Half4> : VertexFormatInfo<VK_FORMAT_R16G16B16A16_SFLOAT> { };
+    template<> struct VertexFormat<Snorm16x2> : VertexFormatInfo<VK_FORMAT_R16G16_SNORM> { };
+    template<> struct VertexFormat<Snorm16x4> : VertexFormatInfo<VK_FORMAT_R16G16B16A16_SNORM> { };
+    template<> struct VertexFormat<Unorm16x2> : VertexFormatInfo<VK_FORMAT_R16G16_UNORM> { };
+    template<> struct VertexFormat<Unorm8x4> : VertexFormatInfo<VK_FORMAT_R8G8B8A8_UNORM> { };
+    template<> struct VertexFormat<Uint16x2> : VertexFormatInfo<VK_FORMAT_R16G16_UINT> { };
+
+    template<typename>
+    struct MemberPointer;
+
+    template<typename Class, typename Member>
+    struct MemberPointer<Member Class::*> {
+        using class_type = Class;
+        using member_type = Member;
+    };
+
+    /*
+     *  The vertex input of one vertex buffer binding, derived at compile time from the members of its struct:
+     *
+     *      using Layout = VertexLayout<VK_VERTEX_INPUT_RATE_VERTEX, &Vertex::position, &Vertex::UV>;
+     *
+     *  Every member must be listed, in declaration order. Offsets follow from the member types and their alignment.
+     *      A member list out of declaration order, or one whose packed size differs from the struct's (a missing
+     *      member, or padding beyond natural alignment), fails to compile.
+     */
+    template<VkVertexInputRate InputRate, auto... Members>
+    struct VertexLayout {
+        static_assert(sizeof...(Members) > 0, "A vertex layout needs at least one member.");
+
+        using Vertex = typename MemberPointer<std::tuple_element_t<0, std::tuple<decltype(Members)...>>>::class_type;
+
+        static_assert((std::is_same_v<typename MemberPointer<decltype(Members)>::class_type, Vertex> && ...), "Every member must belong to the same struct.");
+        static_assert(std::is_standard_layout_v<Vertex>, "Vertex structs must be standard layout.");
+
+        static constexpr std::uint32_t attribute_count = (VertexFormat<typename MemberPointer<decltype(Members)>::member_type>::locations + ...);
+
+        static constexpr VkVertexInputBindingDescription binding_description(const std::uint32_t binding) {
+            return VkVertexInputBindingDescription {
+                .binding   = binding,
+                .stride    = static_cast<std::uint32_t>(sizeof(Vertex)),
+                .inputRate = InputRate
+            };
+        }
+
+        /// Locations are assigned in member order starting at first_location
+        static constexpr std::array<VkVertexInputAttributeDescription, attribute_count> attribute_descriptions(const std::uint32_t binding, const std::uint32_t first_location = 0) {
+            std::array<VkVertexInputAttributeDescription, attribute_count> attributes {};
+
+            std::uint32_t offset = 0;
+            std::uint32_t attribute = 0;
+            ([&] {
+                using Member = typename MemberPointer<decltype(Members)>::member_type;
+                using Format = VertexFormat<Member>;
+
+                offset = _align(offset, alignof(Member));
+                for (std::uint32_t location = 0; location < Format::locations; ++location) {
+                    attributes[attribute] = VkVertexInputAttributeDescription {
+                        .location = first_location + attribute,
+                        .binding  = binding,
+                        .format   = Format::format,
+                        .offset   = offset + location * static_cast<std::uint32_t>(sizeof(Member) / Format::locations)
+                    };
+                    ++attribute;
+                }
+                offset += sizeof(Member);
+            }(), ...);
+
+            return attributes;
+        }
+
+    private:
+        /// Room for a Vertex that is never constructed, so member addresses can be compared in constant expressions
+        union Probe {
+            char none;
+            Vertex vertex;
+
+            constexpr Probe() : none() { }
+            constexpr ~Probe() { }
+        };
+
+        static constexpr std::uint32_t _align(const std::uint32_t offset, const std::uint32_t alignment) {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        static constexpr std::uint32_t _packed_size() {
+            std::uint32_t offset = 0;
+            ((offset = _align(offset, alignof(typename MemberPointer<decltype(Members)>::member_type)) + sizeof(typename MemberPointer<decltype(Members)>::member_type)), ...);
+
+            return _align(offset, alignof(Vertex));
+        }
+
+        /// Members of one object compare by declaration order
+        static constexpr bool _in_declaration_order() {
+            const Probe probe;
+            const void* previous = nullptr;
+            bool ordered = true;
+            ([&] {
+                const void* member = &(probe.vertex.*Members);
+                ordered = ordered && (previous == nullptr || previous < member);
+                previous = member;
+            }(), ...);
+
+            return ordered;
+        }
+
+        static_assert(_in_declaration_order(), "The member list must follow the struct's declaration order.");
+        static_assert(_packed_size() == sizeof(Vertex), "The member list does not match the struct: list every member, in declaration order.");
+    };
+
+    /// Vertex input of a whole pipeline, one VertexLayout per binding (binding n is the nth layout) with locations
+    ///     numbered consecutively across them. Everything lives in static storage, so create_info() allocates nothing.
+    template<typename... Layouts>
+    struct VertexInputLayout {
+        static constexpr std::uint32_t attribute_count = (Layouts::attribute_count + ...);
+
+        static constexpr std::array<VkVertexInputBindingDescription, sizeof...(Layouts)> bindings = [] {
+            std::array<VkVertexInputBindingDescription, sizeof...(Layouts)> descriptions {};
+
+            std::uint32_t binding = 0;
+            ((descriptions[binding] = Layouts::binding_description(binding), ++binding), ...);
+
+            return descriptions;
+        }();
+
+        static constexpr std::array<VkVertexInputAttributeDescription, attribute_count> attributes = [] {
+            std::array<VkVertexInputAttributeDescription, attribute_count> descriptions {};
+
+            std::uint32_t binding = 0;
+            std::uint32_t location = 0;
+            ([&] {
+                for (const auto& attribute : Layouts::attribute_descriptions(binding, location)) {
+                    descriptions[location++] = attribute;
+                }
+                ++binding;
+            }(), ...);
+
+            return descriptions;
+        }();
+
+        static VkPipelineVertexInputStateCreateInfo create_info() {
+            return VkPipelineVertexInputStateCreateInfo {
+                .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+                .vertexBindingDescriptionCount   = static_cast<std::uint32_t>(bindings.size()),
+                .pVertexBindingDescriptions      = bindings.data(),
+                .vertexAttributeDescriptionCount = static_cast<std::uint32_t>(attributes.size()),
+                .pVertexAttributeDescriptions    = attributes.data()
+            };
+        }
+    };
+}  // namespace fr
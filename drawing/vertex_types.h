@@ -2,8 +2,16 @@
 
 #include "vertex_info.h"
 #include "descriptor_set_types.h"
+#include "utils/thread_pool.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <future>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -50,35 +58,72 @@ namespace fr {
         glm::vec3 color;
         glm::vec2 tex;
 
+        using Layout = VertexLayout<VK_VERTEX_INPUT_RATE_VERTEX, &HelloTriangleVertex::position, &HelloTriangleVertex::color, &HelloTriangleVertex::tex>;
+
         /// Add the Hello Triangle attributes and binding descriptions to the input vertex info at the specified binding
         void generate_vertex_info(VertexInfo& vertex_info, const std::uint32_t binding) const {
-            // Make the attribute descriptions
-            vertex_info.add_attribute_description(position, offsetof(HelloTriangleVertex, position), binding);
-            vertex_info.add_attribute_description(color, offsetof(HelloTriangleVertex, color), binding);
-            vertex_info.add_attribute_description(tex, offsetof(HelloTriangleVertex, tex), binding);
-
-            // Make the binding descriptions
-            vertex_info.add_binding_description(sizeof(HelloTriangleVertex), binding, VK_VERTEX_INPUT_RATE_VERTEX);
-
+            vertex_info.add_layout<Layout>(binding);
             vertex_info.generate_vertex_info();  // update the vertex info
         }
     };
 
 
     namespace Grid2D {
+        /// Largest grid width whose index count, 6 * (width - 1)^2, fits the 32-bit draw count. Its vertices fit
+        ///     Vertex::grid and 32-bit indices with room to spare.
+        inline constexpr std::uint32_t max_width = 26755;
+
+        /// Grid coordinates of a vertex, 4 bytes. The position and UV are affine in them, so the shader rebuilds both
+        ///     from the instance's Dequantization and every tile of the same width shares one vertex buffer.
         struct Vertex {
-            glm::vec2 position;
-            glm::vec2 UV;        // texture coordinates
+            Uint16x2 grid;  // x, z
+
+            using Layout = VertexLayout<VK_VERTEX_INPUT_RATE_VERTEX, &Vertex::grid>;
+        };
+
+        /// Maps Vertex::grid to the tile's position and texture coordinates: value = grid * scale + offset
+        struct Dequantization {
+            glm::vec4 position;  // xy scale, zw offset
+            glm::vec4 UV;        // xy scale, zw offset
+
+            /// origin:    Bottom left corner of the grid
+            /// width:     Number of units along the x and z axes, at least 2
+            /// unit_size: Width of each unit within the grid
+            static Dequantization create(const glm::vec2 origin, const std::uint32_t width, const float unit_size, TextureLimits texture_limits) {
+                // The texture step divides by width - 1
+                if (width < 2) {
+                    throw std::runtime_error("Unable to dequantize a grid narrower than 2 vertices.");
+                }
+
+                const position2D step_size = texture_limits.calculate_step_size(width, width);
+
+                // z runs towards -y in position and from the top of the texture down in UV
+                return Dequantization {
+                    .position = glm::vec4 {unit_size, -unit_size, origin.x, origin.y},
+                    .UV = glm::vec4 {
+                        static_cast<float>(step_size.x),
+                        static_cast<float>(-step_size.y),
+                        static_cast<float>(texture_limits.lower.x),
+                        static_cast<float>((width - 1) * step_size.y + texture_limits.lower.y)
+                    }
+                };
+            }
         };
 
         struct InstanceData {
             glm::mat4 model;
             glm::vec3 color;
             glm::vec2 texture_offset;
+            std::uint32_t texture_layer;  // layer of the colour map texture array (see TextureArray)
+            glm::vec4 position_dequantization;
+            glm::vec4 uv_dequantization;
 
-            explicit InstanceData(const glm::mat4& model_in, const glm::vec2& texture_offset_in)
+            explicit InstanceData(const glm::mat4& model_in, const glm::vec2& texture_offset_in, const Dequantization& dequantization_in, const std::uint32_t texture_layer_in = 0)
                 : model(model_in)
                 , texture_offset(texture_offset_in)
+                , texture_layer(texture_layer_in)
+                , position_dequantization(dequantization_in.position)
+                , uv_dequantization(dequantization_in.UV)
             {
                 color = {pick_random_color_value(), pick_random_color_value(), pick_random_color_value()};
             }
@@ -86,53 +131,139 @@ namespace fr {
             static float pick_random_color_value() {
                 return (float)(rand() % 100) / 100;
             }
+
+            using Layout = VertexLayout<
+                VK_VERTEX_INPUT_RATE_INSTANCE,
+                &InstanceData::model,
+                &InstanceData::color,
+                &InstanceData::texture_offset,
+                &InstanceData::texture_layer,
+                &InstanceData::position_dequantization,
+                &InstanceData::uv_dequantization
+            >;
         };
 
+        /// Per-vertex data at binding 0, per-instance data at binding 1
+        using InputLayout = VertexInputLayout<Vertex::Layout, InstanceData::Layout>;
+
         void inline generate_vertex_info(VertexInfo& vertex_info) {
-            // Vertex data
-            const auto [position, UV] = Vertex {};
-            vertex_info.add_attribute_description(position, offsetof(Vertex, position), 0);
-            vertex_info.add_attribute_description(UV, offsetof(Vertex, UV), 0);
-            vertex_info.add_binding_description(sizeof(Vertex), 0, VK_VERTEX_INPUT_RATE_VERTEX);
+            vertex_info.add_layout<Vertex::Layout>(0);
+            vertex_info.add_layout<InstanceData::Layout>(1);
 
+            vertex_info.generate_vertex_info();  // update the vertex info
+        }
 
-            // Instanced data
-            const auto [model, color, texture_offset] = InstanceData(glm::mat4(0), {});
-            vertex_info.add_attribute_description(model, offsetof(InstanceData, model), 1);
-            vertex_info.add_attribute_description(color, offsetof(InstanceData, color), 1);
-            vertex_info.add_attribute_description(texture_offset, offsetof(InstanceData, texture_offset), 1);
-            vertex_info.add_binding_description(sizeof(InstanceData), 1, VK_VERTEX_INPUT_RATE_INSTANCE);
+        [[nodiscard]] constexpr std::size_t vertex_count(const std::uint32_t width) {
+            return static_cast<std::size_t>(width) * width;
+        }
 
-            vertex_info.generate_vertex_info();  // update the vertex info
+        /// Two triangles per quad, (width - 1)^2 quads
+        [[nodiscard]] constexpr std::size_t index_count(const std::uint32_t width) {
+            return width < 2 ? 0 : static_cast<std::size_t>(width - 1) * (width - 1) * 6;
         }
 
-        /// Generates the vertices of a square grid
-        /// origin:    Bottom left corner of the grid
-        /// width:     Number of units along the x and z axes
-        /// unit_size: Width of each unit within the grid
-        static std::vector<Vertex> generate_vertices(const glm::vec2 origin, const std::uint32_t width, const float unit_size, TextureLimits texture_limits) {
-            std::vector<Vertex> grid = {};
-            const std::uint32_t n_positions = width * width;
-            grid.reserve(n_positions);
-
-            position2D step_size = texture_limits.calculate_step_size(width, width);
-
-            for (int z = 0; z < width; ++z) {
-                for (int x = 0; x < width; ++x) {
-                    auto curr_grid = Vertex {};
-                    curr_grid.position = {
-                        origin.x + (static_cast<float>(x) * unit_size),
-                        origin.y - (static_cast<float>(z) * unit_size)
-                    };
-
-                    curr_grid.UV = {
-                        x * step_size.x + texture_limits.lower.x,
-                        (width - z - 1) * step_size.y + texture_limits.lower.y
-                    };
-
-                    grid.emplace_back(curr_grid);
+        static_assert(index_count(max_width) <= std::numeric_limits<std::uint32_t>::max() &&
+            index_count(max_width + 1) > std::numeric_limits<std::uint32_t>::max(), "max_width must be the largest width with a 32-bit index count.");
+        static_assert(max_width <= std::numeric_limits<std::uint16_t>::max(), "Grid coordinates must fit Vertex::grid.");
+
+        /// Runs generate_rows(first_row, last_row) over contiguous row ranges covering [0, rows). The ranges are
+        ///     spread across pool, with one kept on the calling thread, so pool must not be the pool running the caller.
+        template<typename F>
+        static void for_each_row_range(const std::uint32_t rows, ThreadPool* pool, F&& generate_rows) {
+            // Below this a range costs more to schedule than to generate
+            constexpr std::uint32_t min_rows_per_range = 32;
+
+            const std::size_t n_ranges = pool == nullptr ? 1 : std::clamp<std::size_t>(rows / min_rows_per_range, 1, pool->size() + 1);
+            const std::uint32_t rows_per_range = static_cast<std::uint32_t>((rows + n_ranges - 1) / n_ranges);
+
+            std::vector<std::future<void>> pending;
+            pending.reserve(n_ranges - 1);
+
+            std::uint32_t first_row = 0;
+            for (std::size_t range = 0; range + 1 < n_ranges && first_row < rows; ++range) {
+                const std::uint32_t last_row = std::min(rows, first_row + rows_per_range);
+                pending.push_back(pool->submit([&generate_rows, first_row, last_row] { generate_rows(first_row, last_row); }));
+                first_row = last_row;
+            }
+
+            // The submitted ranges reference generate_rows, so they must finish before an exception leaves this scope
+            try {
+                generate_rows(first_row, rows);
+            } catch (...) {
+                for (auto& range : pending) {
+                    range.wait();
                 }
+                throw;
+            }
+
+            for (auto& range : pending) {
+                range.get();
             }
+        }
+
+        /// Writes rows [first_row, last_row) of the grid's vertices. The inner loop is branch free over contiguous
+        ///     memory, so the compiler vectorises it.
+        static void generate_vertex_rows(const std::uint32_t width, const std::uint32_t first_row, const std::uint32_t last_row, Vertex* vertices) {
+            for (std::uint32_t z = first_row; z < last_row; ++z) {
+                Vertex* row = vertices + static_cast<std::size_t>(z) * width;
+                const auto grid_z = static_cast<std::uint16_t>(z);
+
+                for (std::uint32_t x = 0; x < width; ++x) {
+                    row[x].grid = {static_cast<std::uint16_t>(x), grid_z};
+                }
+            }
+        }
+
+        /// Writes the indices of quad rows [first_row, last_row), a quad row lies between vertex rows z and z + 1
+        static void generate_index_rows(const std::uint32_t width, const std::uint32_t first_row, const std::uint32_t last_row, std::uint32_t* indices) {
+            const std::uint32_t quads_per_row = width - 1;
+
+            for (std::uint32_t z = first_row; z < last_row; ++z) {
+                std::uint32_t* row = indices + static_cast<std::size_t>(z) * quads_per_row * 6;
+                const std::uint32_t row_start = z * width;
+
+                for (std::uint32_t x = 0; x < quads_per_row; ++x) {
+                    const std::uint32_t i = row_start + x;
+                    std::uint32_t* quad = row + static_cast<std::size_t>(x) * 6;
+
+                    // left triangle
+                    quad[0] = i;
+                    quad[1] = i + 1;
+                    quad[2] = i + width;
+
+                    // right triangle
+                    quad[3] = i + 1;
+                    quad[4] = i + width;
+                    quad[5] = i + width + 1;
+                }
+            }
+        }
+
+        static void validate_width(const std::uint32_t width) {
+            if (width > max_width) {
+                throw std::runtime_error("Grid width " + std::to_string(width) + " exceeds Grid2D::max_width.");
+            }
+        }
+
+        /// Generates the vertices of a square grid, width vertices along the x and z axes, into vertices (e.g. a
+        ///     mapped staging buffer) which must hold vertex_count(width). Place and texture it with a Dequantization
+        ///     per instance. Rows are generated in parallel on pool when one is given.
+        static void generate_vertices(const std::uint32_t width, const std::span<Vertex> vertices, ThreadPool* pool = nullptr) {
+            validate_width(width);
+            if (vertices.size() < vertex_count(width)) {
+                throw std::runtime_error("The vertex output holds fewer than Grid2D::vertex_count(width) vertices.");
+            }
+
+            for_each_row_range(width, pool, [width, out = vertices.data()](const std::uint32_t first_row, const std::uint32_t last_row) {
+                generate_vertex_rows(width, first_row, last_row, out);
+            });
+        }
+
+        static std::vector<Vertex> generate_vertices(const std::uint32_t width, ThreadPool* pool = nullptr) {
+            validate_width(width);
+
+            std::vector<Vertex> grid(vertex_count(width));
+            generate_vertices(width, grid, pool);
 
             return grid;
         }
@@ -142,29 +273,27 @@ namespace fr {
             return position % width == width - 1;
         }
 
-        /// Generates the index positions for a grid with a given width
-        static std::vector<std::uint32_t> generate_indices(const std::uint32_t width) {
-            const std::uint32_t n_positions = width * width;
-
-            std::vector<std::uint32_t> indices = {};
-            indices.reserve(n_positions * 3);
+        /// Generates the index positions for a grid with a given width into indices, which must hold
+        ///     index_count(width). Rows are generated in parallel on pool when one is given.
+        static void generate_indices(const std::uint32_t width, const std::span<std::uint32_t> indices, ThreadPool* pool = nullptr) {
+            validate_width(width);
+            if (indices.size() < index_count(width)) {
+                throw std::runtime_error("The index output holds fewer than Grid2D::index_count(width) indices.");
+            }
+            if (width < 2) {
+                return;
+            }
 
-            std::uint32_t final_row = n_positions - width;
-            for (std::uint32_t i = 0; i < n_positions; ++i) {
-                if (i >= final_row || is_right_edge(i, width)) {
-                    continue;
-                }
+            for_each_row_range(width - 1, pool, [width, out = indices.data()](const std::uint32_t first_row, const std::uint32_t last_row) {
+                generate_index_rows(width, first_row, last_row, out);
+            });
+        }
 
-                // left triangle
-                indices.emplace_back(i);
-                indices.emplace_back(i + 1);
-                indices.emplace_back(i + width);
+        static std::vector<std::uint32_t> generate_indices(const std::uint32_t width, ThreadPool* pool = nullptr) {
+            validate_width(width);
 
-                // right triangle
-                indices.emplace_back(i + 1);
-                indices.emplace_back(i + width);
-                indices.emplace_back(i + width + 1);
-            }
+            std::vector<std::uint32_t> indices(index_count(width));
+            generate_indices(width, indices, pool);
 
             return indices;
         }
@@ -7,6 +7,11 @@
 #include "drawing/descriptor_set_types.h"
 #include "shaders/shader.h"
 
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
 SampleApplication::SampleApplication()
     : _vulkan_builder(std::make_unique<fr::VulkanBuilder>())
     , _texture(std::make_unique<fr::Texture>(_vulkan_builder->get_context()))
@@ -16,23 +21,36 @@ void SampleApplication::init() {
     _vulkan_builder->prepare();
     _context = _vulkan_builder->get_context();
 
-    // Create the vertex info
-    fr::VertexInfo vertex_info {};
-    constexpr fr::HelloTriangleVertex hello_triangle_vertex {};
-    hello_triangle_vertex.generate_vertex_info(vertex_info, 0);
-
     // Create shader stages
-    auto shader = fr::Shader("basic", _context->device);
-    shader.create_shader_program();
+    const std::string shader_name = "basic";
+    auto shader = fr::Shader(shader_name, _context->device);
+    shader.create_shader_program(_context->features);
     auto shader_stages = shader.get_shader_stages();
 
+    // Create the vertex info from the shader's inputs, which are laid out in location order like HelloTriangleVertex
+    const fr::ShaderReflection& reflection = shader.get_reflection();
+    fr::VertexInfo vertex_info = reflection.create_vertex_info({fr::VertexBindingLayout {.stride = sizeof(fr::HelloTriangleVertex)}});
+
     // Set vertices data and descriptor sets
     set_uniforms();
 
+    // Layouts are cached by signature, so the shader's set 0 is the same handle only if set_uniforms() declared it correctly
+    if (reflection.create_set_layouts(*_context->descriptor_layout_cache).at(0) != _context->descriptor.layout) {
+        throw std::runtime_error("The descriptors created in set_uniforms() do not match the bindings of the basic shader.");
+    }
+
     // Create the graphics pipeline
     auto terrain_pipeline = fr::GraphicsPipeline(_context);
     terrain_pipeline.create_pipeline(vertex_info, shader_stages);
 
+#ifdef FR_SHADER_HOT_RELOAD
+    // Reloaded shaders are compiled into the same pipeline, only the stages change
+    _pipeline_description = terrain_pipeline.describe(vertex_info, shader_stages, shader.get_code_hash());
+    _pipeline_shader = shader_name;
+    _pipeline_registry = std::make_unique<fr::PipelineRegistry>(_context, 1);
+    _shader_watcher = std::make_unique<fr::ShaderWatcher>(FR_SHADER_SOURCE_DIR, FR_SLANGC);
+#endif
+
     shader.destroy_shaders();  // shaders are now baked into the pipeline, we can now freely destroy them
 }
 
@@ -107,5 +125,82 @@ void SampleApplication::run() {
 
         // Update MVP descriptor set
         fr::ViewProj::update(_context->allocator, _context->descriptor.uniform_buffer.allocation, _context->swap_chain_dimensions);
+
+#ifdef FR_SHADER_HOT_RELOAD
+        if (_reload_shaders(renderer_params)) {
+            renderer.update_command_buffers(renderer_params);
+        }
+#endif
     }
 }
+
+#ifdef FR_SHADER_HOT_RELOAD
+bool SampleApplication::_reload_shaders(fr::RendererParams& renderer_params) {
+    _pipeline_registry->end_frame();
+
+    for (auto& compiled : _shader_watcher->take_compiled()) {
+        if (compiled.name != _pipeline_shader) {
+            continue;  // Not a shader any of the pipelines is built from
+        }
+
+        // A newer edit supersedes the one still compiling, whose module must outlive its compile
+        if (_pending_variant.has_value()) {
+            try {
+                _pipeline_registry->wait(*_pending_variant);
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to build the reloaded pipeline: " << e.what() << "\n";
+            }
+            _pipeline_registry->retire(*_pending_variant);
+            _pending_variant.reset();
+        }
+
+        _pending_shader = std::make_unique<fr::Shader>(compiled.name, std::move(compiled.code), _context->device);
+        _pending_shader->create_shader_program(_context->features);
+
+        // Only the module changes, entry points and specialization constants are kept
+        fr::PipelineDescription description = _pipeline_description;
+        for (auto& stage : description.stages) {
+            stage.module    = _pending_shader->get_shader_stages().front().module;
+            stage.code_hash = _pending_shader->get_code_hash();
+        }
+
+        const auto variant = _pipeline_registry->request(description);
+        if (renderer_params.pipeline_registry != nullptr && variant == renderer_params.pipeline_variant) {
+            _pending_shader.reset();  // Same SPIR-V as the pipeline already in use
+        } else {
+            _pending_variant = variant;
+        }
+    }
+
+    if (!_pending_variant.has_value()) {
+        return false;
+    }
+
+    // The recorded command buffers keep drawing the current pipeline until the new one is ready
+    const auto completed = _pipeline_registry->take_completed();
+    if (std::ranges::find(completed, *_pending_variant) == completed.end()) {
+        // Failed variants never complete, resolve() rethrows their error
+        try {
+            [[maybe_unused]] const auto variant = _pipeline_registry->resolve(*_pending_variant);
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to build the reloaded pipeline: " << e.what() << "\n";
+
+            _pipeline_registry->retire(*_pending_variant);
+            _pending_variant.reset();
+            _pending_shader.reset();
+        }
+        return false;
+    }
+
+    if (renderer_params.pipeline_registry != nullptr) {
+        _pipeline_registry->retire(renderer_params.pipeline_variant);
+    }
+    renderer_params.pipeline_registry = _pipeline_registry.get();
+    renderer_params.pipeline_variant  = *_pending_variant;
+
+    _pending_variant.reset();
+    _pending_shader.reset();  // The module is baked into the pipeline
+
+    return true;
+}
+#endif
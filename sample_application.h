@@ -9,6 +9,16 @@
 #include "drawing/vertex_types.h"
 #include "builders/texture_loader.h"
 
+#ifdef FR_SHADER_HOT_RELOAD
+#include "drawing/pipeline_registry.h"
+#include "drawing/renderer.h"
+#include "shaders/shader.h"
+#include "shaders/shader_watcher.h"
+
+#include <optional>
+#include <string>
+#endif
+
 inline auto vertices = std::vector<fr::HelloTriangleVertex> {
     {{0.5f, -0.5f},  {1.0f, 0.0f, 0.0f}, {1, 1}},        // Vertex 1: Red
 
@@ -31,4 +41,16 @@ private:
     std::unique_ptr<fr::VulkanBuilder> _vulkan_builder;
     std::shared_ptr<VkContext> _context;
     std::unique_ptr<fr::Texture> _texture;
+
+#ifdef FR_SHADER_HOT_RELOAD
+    fr::PipelineDescription _pipeline_description;
+    std::string _pipeline_shader;  // Edits to other shaders are ignored
+    std::unique_ptr<fr::Shader> _pending_shader;  // Kept alive until its pipeline has compiled, so declared before the registry
+    std::unique_ptr<fr::PipelineRegistry> _pipeline_registry;
+    std::unique_ptr<fr::ShaderWatcher> _shader_watcher;
+    std::optional<fr::PipelineRegistry::Handle> _pending_variant;
+
+    /// Swaps in pipelines rebuilt from edited shaders; returns true when the command buffers must be re-recorded
+    bool _reload_shaders(fr::RendererParams& renderer_params);
+#endif
 };
\ No newline at end of file
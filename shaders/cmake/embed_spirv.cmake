@@ -0,0 +1,33 @@
+# Writes a SPIR-V binary as a constexpr std::uint32_t array.
+#
+# Usage: cmake -DINPUT=<file.spv> -DOUTPUT=<file.h> -DSYMBOL=<name> -P embed_spirv.cmake
+
+file(READ "${INPUT}" spirv_hex HEX)
+string(LENGTH "${spirv_hex}" spirv_hex_length)
+
+math(EXPR spirv_remainder "${spirv_hex_length} % 8")
+if (spirv_hex_length EQUAL 0 OR NOT spirv_remainder EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a SPIR-V binary (size is not a multiple of 4 bytes)")
+endif ()
+
+# SPIR-V words are little endian: reverse the bytes of each 4 byte group
+string(REGEX REPLACE
+    "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])"
+    "0x\\4\\3\\2\\1u,"
+    spirv_words
+    "${spirv_hex}"
+)
+string(REGEX REPLACE "(0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,0x[0-9a-f]+u,)" "\\1\n    " spirv_words "${spirv_words}")
+
+file(WRITE "${OUTPUT}"
+"// Generated from ${INPUT} by embed_spirv.cmake, do not edit.
+#pragma once
+
+#include <cstdint>
+
+namespace fr::embedded {
+    inline constexpr std::uint32_t ${SYMBOL}[] = {
+    ${spirv_words}
+    };
+}  // namespace fr::embedded
+")
@@ -0,0 +1,18 @@
+#include "embedded_shaders.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "embedded_shaders.inl"
+
+namespace fr {
+    std::span<const std::uint32_t> embedded_spirv(const std::string_view name) {
+        for (const auto& shader : embedded::shaders) {
+            if (shader.name == name) {
+                return shader.spirv;
+            }
+        }
+
+        throw std::runtime_error("No embedded shader named " + std::string(name) + ".");
+    }
+}  // namespace fr
@@ -1,6 +1,8 @@
 #include "shader.h"
+#include "embedded_shaders.h"
 #include "utils/file_system.h"
 
+#include <stdexcept>
 #include <utility>
 #include <utils/error.h>
 
@@ -8,50 +10,84 @@ namespace fr {
     Shader::Shader(std::string shader_name, const VkDevice& device)
         : _shader_name(std::move(shader_name))
         , _device(device)
+        , _code(embedded_spirv(_shader_name))
+    { }
+
+    Shader::Shader(std::string shader_name, std::vector<std::uint32_t> code, const VkDevice& device)
+        : _shader_name(std::move(shader_name))
+        , _device(device)
+        , _owned_code(std::move(code))
+        , _code(_owned_code)
     { }
 
     Shader::~Shader() {
         destroy_shaders();
     }
 
-    void Shader::create_shader_program() {
-        _read_shader_file();
+    void Shader::create_shader_program(const Features& features) {
+        // Creating a module with a capability the device does not enable is invalid, so fail before that
+        if (get_reflection().requires_buffer_device_address() && !features.buffer_device_address) {
+            throw std::runtime_error("Shader \"" + _shader_name + "\" reads buffers through device addresses, which the device does not support.");
+        }
+
+        _code_hash = file_system::hash_bytes(_code.data(), _code.size_bytes());
+        _shader_module = _create_shader_module();
+
+        // Both stages come from the same module, selected by entry point
+        const auto vertex_info = _create_shader_stage_info(_shader_module, VK_SHADER_STAGE_VERTEX_BIT, "vertex_main");
+        const auto fragment_info = _create_shader_stage_info(_shader_module, VK_SHADER_STAGE_FRAGMENT_BIT, "fragment_main");
+
+        _shader_stages = {vertex_info, fragment_info};
     }
 
     std::vector<VkPipelineShaderStageCreateInfo> Shader::get_shader_stages() const {
-        return _shader_stages;
+        std::vector<VkPipelineShaderStageCreateInfo> stages = _shader_stages;
+        if (!_specialization.empty()) {
+            for (auto& stage : stages) {
+                stage.pSpecializationInfo = &_specialization_info;
+            }
+        }
+
+        return stages;
     }
 
-    void Shader::destroy_shaders() {
-        if (_vertex_shader_module != VK_NULL_HANDLE) {
-            vkDestroyShaderModule(_device, _vertex_shader_module, nullptr);
-            _vertex_shader_module = VK_NULL_HANDLE;
-        }
-        if (_fragment_shader_module != VK_NULL_HANDLE) {
-            vkDestroyShaderModule(_device, _fragment_shader_module, nullptr);
-            _fragment_shader_module = VK_NULL_HANDLE;
-        }
+    void Shader::set_specialization_constants(SpecializationConstants constants) {
+        _specialization = std::move(constants);
+        _specialization_info = _specialization.get_info();
     }
 
-    void Shader::_read_shader_file() {
-        std::vector<char> vertex_shader_code = file_system::read_binary_file(shader_dir + _shader_name + ".spv");
-        std::vector<char> fragment_shader_code = file_system::read_binary_file(shader_dir + _shader_name + ".spv");
+    const SpecializationConstants& Shader::get_specialization_constants() const {
+        return _specialization;
+    }
 
-        _vertex_shader_module = _create_shader_module(vertex_shader_code);
-        _fragment_shader_module = _create_shader_module(fragment_shader_code);
+    std::span<const std::uint32_t> Shader::get_code() const {
+        return _code;
+    }
 
-        // Define the vertex shader info
-        const auto vertex_info = _create_shader_stage_info(_vertex_shader_module, VK_SHADER_STAGE_VERTEX_BIT, "vertex_main");
-        const auto fragment_info = _create_shader_stage_info(_fragment_shader_module, VK_SHADER_STAGE_FRAGMENT_BIT, "fragment_main");
+    std::uint64_t Shader::get_code_hash() const {
+        return _code_hash;
+    }
 
-        _shader_stages = {vertex_info, fragment_info};
+    const ShaderReflection& Shader::get_reflection() {
+        if (!_reflection.has_value()) {
+            _reflection.emplace(_code);
+        }
+
+        return *_reflection;
+    }
+
+    void Shader::destroy_shaders() {
+        if (_shader_module != VK_NULL_HANDLE) {
+            vkDestroyShaderModule(_device, _shader_module, nullptr);
+            _shader_module = VK_NULL_HANDLE;
+        }
     }
 
-    VkShaderModule Shader::_create_shader_module(const std::vector<char>& code) {
+    VkShaderModule Shader::_create_shader_module() const {
         VkShaderModuleCreateInfo shader_create_info = {};
         shader_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        shader_create_info.codeSize = code.size();
-        shader_create_info.pCode = reinterpret_cast<const std::uint32_t*>(code.data());
+        shader_create_info.codeSize = _code.size_bytes();
+        shader_create_info.pCode = _code.data();
 
         VkShaderModule shader_module;
         validate(
@@ -0,0 +1,608 @@
+#include "shader_reflection.h"
+#include "drawing/descriptor_allocator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace fr {
+    namespace {
+        constexpr std::uint32_t spirv_magic = 0x07230203;
+        constexpr std::uint32_t spirv_header_words = 5;
+        constexpr std::uint32_t spirv_version_1_4 = 0x00010400;
+
+        namespace op {
+            constexpr std::uint32_t entry_point = 15;
+            constexpr std::uint32_t capability = 17;
+            constexpr std::uint32_t type_void = 19;
+            constexpr std::uint32_t type_bool = 20;
+            constexpr std::uint32_t type_int = 21;
+            constexpr std::uint32_t type_float = 22;
+            constexpr std::uint32_t type_vector = 23;
+            constexpr std::uint32_t type_matrix = 24;
+            constexpr std::uint32_t type_image = 25;
+            constexpr std::uint32_t type_sampler = 26;
+            constexpr std::uint32_t type_sampled_image = 27;
+            constexpr std::uint32_t type_array = 28;
+            constexpr std::uint32_t type_runtime_array = 29;
+            constexpr std::uint32_t type_struct = 30;
+            constexpr std::uint32_t type_pointer = 32;
+            constexpr std::uint32_t constant = 43;
+            constexpr std::uint32_t variable = 59;
+            constexpr std::uint32_t decorate = 71;
+            constexpr std::uint32_t member_decorate = 72;
+            constexpr std::uint32_t type_acceleration_structure = 5341;
+        }
+
+        namespace decoration {
+            constexpr std::uint32_t buffer_block = 3;
+            constexpr std::uint32_t array_stride = 6;
+            constexpr std::uint32_t matrix_stride = 7;
+            constexpr std::uint32_t built_in = 11;
+            constexpr std::uint32_t location = 30;
+            constexpr std::uint32_t binding = 33;
+            constexpr std::uint32_t descriptor_set = 34;
+            constexpr std::uint32_t offset = 35;
+        }
+
+        constexpr std::uint32_t capability_physical_storage_buffer_addresses = 5347;
+
+        namespace storage_class {
+            constexpr std::uint32_t uniform_constant = 0;
+            constexpr std::uint32_t input = 1;
+            constexpr std::uint32_t uniform = 2;
+            constexpr std::uint32_t push_constant = 9;
+            constexpr std::uint32_t storage_buffer = 12;
+            constexpr std::uint32_t physical_storage_buffer = 5349;
+        }
+
+        constexpr std::uint32_t image_dim_buffer = 5;
+        constexpr std::uint32_t image_dim_subpass_data = 6;
+
+        struct Type {
+            std::uint32_t opcode;
+            std::vector<std::uint32_t> operands;  // Words after the result id
+        };
+
+        struct Decorations {
+            std::optional<std::uint32_t> set;
+            std::optional<std::uint32_t> binding;
+            std::optional<std::uint32_t> location;
+            std::optional<std::uint32_t> array_stride;
+            bool buffer_block = false;
+            bool built_in = false;
+        };
+
+        struct MemberDecorations {
+            std::optional<std::uint32_t> offset;
+            std::optional<std::uint32_t> matrix_stride;
+        };
+
+        struct Variable {
+            std::uint32_t type;  // Pointer type
+            std::uint32_t storage_class;
+            VkShaderStageFlags stages = 0;
+        };
+
+        struct EntryPoint {
+            VkShaderStageFlags stage;
+            std::vector<std::uint32_t> interface;
+        };
+
+        /// Storage classes of descriptors, push constants and vertex inputs; variables of any other class are never reflected
+        bool is_reflected(const std::uint32_t storage) {
+            switch (storage) {
+                case storage_class::uniform_constant:
+                case storage_class::input:
+                case storage_class::uniform:
+                case storage_class::push_constant:
+                case storage_class::storage_buffer:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        VkShaderStageFlags to_stage(const std::uint32_t execution_model) {
+            switch (execution_model) {
+                case 0:    return VK_SHADER_STAGE_VERTEX_BIT;
+                case 1:    return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case 2:    return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case 3:    return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case 4:    return VK_SHADER_STAGE_FRAGMENT_BIT;
+                case 5:    return VK_SHADER_STAGE_COMPUTE_BIT;
+                case 5364: return VK_SHADER_STAGE_TASK_BIT_EXT;
+                case 5365: return VK_SHADER_STAGE_MESH_BIT_EXT;
+                default:   throw std::runtime_error("Unsupported SPIR-V execution model " + std::to_string(execution_model) + ".");
+            }
+        }
+
+        /// Vertex input format of a scalar or vector with the given component type
+        VkFormat to_format(const Type& component, const std::uint32_t count) {
+            static constexpr VkFormat float32[] = {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+            static constexpr VkFormat sint32[]  = {VK_FORMAT_R32_SINT,   VK_FORMAT_R32G32_SINT,   VK_FORMAT_R32G32B32_SINT,   VK_FORMAT_R32G32B32A32_SINT};
+            static constexpr VkFormat uint32[]  = {VK_FORMAT_R32_UINT,   VK_FORMAT_R32G32_UINT,   VK_FORMAT_R32G32B32_UINT,   VK_FORMAT_R32G32B32A32_UINT};
+            static constexpr VkFormat float16[] = {VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT};
+            static constexpr VkFormat sint16[]  = {VK_FORMAT_R16_SINT,   VK_FORMAT_R16G16_SINT,   VK_FORMAT_R16G16B16_SINT,   VK_FORMAT_R16G16B16A16_SINT};
+            static constexpr VkFormat uint16[]  = {VK_FORMAT_R16_UINT,   VK_FORMAT_R16G16_UINT,   VK_FORMAT_R16G16B16_UINT,   VK_FORMAT_R16G16B16A16_UINT};
+            static constexpr VkFormat float64[] = {VK_FORMAT_R64_SFLOAT, VK_FORMAT_R64G64_SFLOAT, VK_FORMAT_R64G64B64_SFLOAT, VK_FORMAT_R64G64B64A64_SFLOAT};
+
+            if (count == 0 || count > 4) {
+                throw std::runtime_error("Unsupported vertex input component count.");
+            }
+
+            const std::uint32_t width = component.operands.at(0);
+            if (component.opcode == op::type_float) {
+                switch (width) {
+                    case 16: return float16[count - 1];
+                    case 32: return float32[count - 1];
+                    case 64: return float64[count - 1];
+                    default: break;
+                }
+            } else if (component.opcode == op::type_int) {
+                const bool is_signed = component.operands.at(1) != 0;
+                switch (width) {
+                    case 16: return is_signed ? sint16[count - 1] : uint16[count - 1];
+                    case 32: return is_signed ? sint32[count - 1] : uint32[count - 1];
+                    default: break;
+                }
+            }
+
+            throw std::runtime_error("Unsupported vertex input type.");
+        }
+
+        /// The parsed module, only the instructions reflection needs
+        class Module {
+        public:
+            explicit Module(const std::span<const std::uint32_t> spirv) {
+                if (spirv.size() < spirv_header_words || spirv[0] != spirv_magic) {
+                    throw std::runtime_error("Not a SPIR-V module.");
+                }
+                _version = spirv[1];
+
+                for (std::size_t i = spirv_header_words; i < spirv.size();) {
+                    const std::uint32_t word_count = spirv[i] >> 16;
+                    const std::uint32_t opcode = spirv[i] & 0xffff;
+                    if (word_count == 0 || i + word_count > spirv.size()) {
+                        throw std::runtime_error("Truncated SPIR-V instruction.");
+                    }
+
+                    _parse(opcode, spirv.subspan(i + 1, word_count - 1));
+                    i += word_count;
+                }
+
+                _assign_stages();
+            }
+
+            std::map<std::uint32_t, Variable> variables;  // Ordered by id so the output is deterministic
+            std::vector<EntryPoint> entry_points;
+            bool uses_device_addresses = false;
+
+            [[nodiscard]] const Type& type(const std::uint32_t id) const {
+                const auto it = _types.find(id);
+                if (it == _types.end()) {
+                    throw std::runtime_error("SPIR-V references an undeclared type.");
+                }
+
+                return it->second;
+            }
+
+            [[nodiscard]] const Decorations& decorations(const std::uint32_t id) const {
+                static const Decorations none;
+                const auto it = _decorations.find(id);
+                return it == _decorations.end() ? none : it->second;
+            }
+
+            [[nodiscard]] std::uint32_t constant(const std::uint32_t id) const {
+                const auto it = _constants.find(id);
+                if (it == _constants.end()) {
+                    throw std::runtime_error("Array length is not a constant (specialization constants are not supported).");
+                }
+
+                return it->second;
+            }
+
+            /// The type a pointer points at
+            [[nodiscard]] std::uint32_t pointee(const std::uint32_t pointer) const {
+                const Type& pointer_type = type(pointer);
+                if (pointer_type.opcode != op::type_pointer) {
+                    throw std::runtime_error("SPIR-V variable is not a pointer.");
+                }
+
+                return pointer_type.operands.at(1);
+            }
+
+            /// Size in bytes following the explicit layout decorations where present
+            [[nodiscard]] std::uint32_t size_of(const std::uint32_t id, const std::optional<std::uint32_t> matrix_stride = std::nullopt) const {
+                const Type& t = type(id);
+                switch (t.opcode) {
+                    case op::type_int:
+                    case op::type_float:
+                        return t.operands.at(0) / 8;
+                    case op::type_vector:
+                        return t.operands.at(1) * size_of(t.operands.at(0));
+                    case op::type_matrix:
+                        return t.operands.at(1) * matrix_stride.value_or(size_of(t.operands.at(0)));
+                    case op::type_array: {
+                        const std::uint32_t length = constant(t.operands.at(1));
+                        return length * decorations(id).array_stride.value_or(size_of(t.operands.at(0)));
+                    }
+                    case op::type_runtime_array:
+                        return 0;
+                    case op::type_pointer:
+                        if (t.operands.at(0) == storage_class::physical_storage_buffer) {
+                            return sizeof(std::uint64_t);
+                        }
+                        break;
+                    case op::type_struct: {
+                        const auto members = _member_decorations.find(id);
+                        std::uint32_t size = 0;
+                        for (std::size_t m = 0; m < t.operands.size(); ++m) {
+                            const MemberDecorations* member = members != _member_decorations.end() && m < members->second.size()
+                                ? &members->second[m]
+                                : nullptr;
+
+                            const std::uint32_t offset = member != nullptr && member->offset.has_value() ? *member->offset : size;
+                            const auto stride = member != nullptr ? member->matrix_stride : std::nullopt;
+                            size = std::max(size, offset + size_of(t.operands[m], stride));
+                        }
+                        return size;
+                    }
+                    default:
+                        break;
+                }
+
+                throw std::runtime_error("Cannot size SPIR-V type with opcode " + std::to_string(t.opcode) + ".");
+            }
+
+            /// Lowest explicit member offset of a struct
+            [[nodiscard]] std::uint32_t first_offset(const std::uint32_t id) const {
+                const auto members = _member_decorations.find(id);
+                if (members == _member_decorations.end()) {
+                    return 0;
+                }
+
+                std::optional<std::uint32_t> first;
+                for (const auto& member : members->second) {
+                    if (member.offset.has_value()) {
+                        first = std::min(first.value_or(*member.offset), *member.offset);
+                    }
+                }
+
+                return first.value_or(0);
+            }
+
+        private:
+            std::uint32_t _version = 0;
+            std::unordered_map<std::uint32_t, Type> _types;
+            std::unordered_map<std::uint32_t, std::uint32_t> _constants;
+            std::unordered_map<std::uint32_t, Decorations> _decorations;
+            std::unordered_map<std::uint32_t, std::vector<MemberDecorations>> _member_decorations;
+
+            void _parse(const std::uint32_t opcode, const std::span<const std::uint32_t> operands) {
+                if (opcode == op::capability) {
+                    uses_device_addresses |= !operands.empty() && operands[0] == capability_physical_storage_buffer_addresses;
+                    return;
+                }
+
+                // Every instruction read below has at least a result and two more operands, except the ones with a result only
+                const bool has_result_only = opcode == op::type_void || opcode == op::type_bool || opcode == op::type_sampler ||
+                    opcode == op::type_acceleration_structure || opcode == op::type_struct;
+                if (operands.size() < (has_result_only ? 1u : 2u)) {
+                    return;
+                }
+
+                switch (opcode) {
+                    case op::entry_point: {
+                        // Operands: execution model, function id, name (nul terminated, word padded), interface ids
+                        const auto* name = reinterpret_cast<const char*>(operands.data() + 2);
+                        const std::size_t name_bytes = (operands.size() - 2) * sizeof(std::uint32_t);
+                        const std::size_t name_words = strnlen(name, name_bytes) / sizeof(std::uint32_t) + 1;
+                        const auto interface = operands.subspan(std::min(operands.size(), 2 + name_words));
+
+                        entry_points.push_back(EntryPoint {
+                            .stage     = to_stage(operands[0]),
+                            .interface = {interface.begin(), interface.end()}
+                        });
+                        break;
+                    }
+                    case op::type_void:
+                    case op::type_bool:
+                    case op::type_int:
+                    case op::type_float:
+                    case op::type_vector:
+                    case op::type_matrix:
+                    case op::type_image:
+                    case op::type_sampler:
+                    case op::type_sampled_image:
+                    case op::type_array:
+                    case op::type_runtime_array:
+                    case op::type_struct:
+                    case op::type_pointer:
+                    case op::type_acceleration_structure:
+                        _types[operands[0]] = Type {opcode, {operands.begin() + 1, operands.end()}};
+                        break;
+                    case op::constant:
+                        // Only 32 bit constants are needed, for array lengths
+                        if (operands.size() >= 3) {
+                            _constants[operands[1]] = operands[2];
+                        }
+                        break;
+                    case op::variable:
+                        if (operands.size() < 3) {
+                            break;
+                        }
+                        variables[operands[1]] = Variable {.type = operands[0], .storage_class = operands[2]};
+                        break;
+                    case op::decorate: {
+                        Decorations& target = _decorations[operands[0]];
+                        const std::uint32_t value = operands.size() > 2 ? operands[2] : 0;
+                        switch (operands[1]) {
+                            case decoration::buffer_block:   target.buffer_block = true; break;
+                            case decoration::array_stride:   target.array_stride = value; break;
+                            case decoration::built_in:       target.built_in = true; break;
+                            case decoration::location:       target.location = value; break;
+                            case decoration::binding:        target.binding = value; break;
+                            case decoration::descriptor_set: target.set = value; break;
+                            default: break;
+                        }
+                        break;
+                    }
+                    case op::member_decorate: {
+                        if (operands.size() < 3) {
+                            break;
+                        }
+                        auto& members = _member_decorations[operands[0]];
+                        if (members.size() <= operands[1]) {
+                            members.resize(operands[1] + 1);
+                        }
+
+                        const std::uint32_t value = operands.size() > 3 ? operands[3] : 0;
+                        if (operands[2] == decoration::offset) {
+                            members[operands[1]].offset = value;
+                        } else if (operands[2] == decoration::matrix_stride) {
+                            members[operands[1]].matrix_stride = value;
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+
+            void _assign_stages() {
+                // Before SPIR-V 1.4 the interface lists only inputs and outputs, so resources belong to every stage
+                VkShaderStageFlags all_stages = 0;
+                for (const auto& entry_point : entry_points) {
+                    all_stages |= entry_point.stage;
+                }
+
+                for (auto& [id, variable] : variables) {
+                    const bool listed = _version >= spirv_version_1_4 ||
+                        variable.storage_class == storage_class::input;
+                    if (!listed) {
+                        variable.stages = all_stages;
+                    }
+                }
+
+                for (const auto& entry_point : entry_points) {
+                    for (const std::uint32_t id : entry_point.interface) {
+                        if (const auto it = variables.find(id); it != variables.end()) {
+                            it->second.stages |= entry_point.stage;
+                        }
+                    }
+                }
+            }
+        };
+
+        /// Descriptor type of a resource variable, or nothing when it is not a descriptor
+        std::optional<VkDescriptorType> to_descriptor_type(const Module& module, const Variable& variable, const std::uint32_t resource_type) {
+            const Type& t = module.type(resource_type);
+
+            switch (variable.storage_class) {
+                case storage_class::uniform_constant:
+                    switch (t.opcode) {
+                        case op::type_sampled_image:
+                            return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                        case op::type_sampler:
+                            return VK_DESCRIPTOR_TYPE_SAMPLER;
+                        case op::type_acceleration_structure:
+                            return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                        case op::type_image: {
+                            // Operands: sampled type, dim, depth, arrayed, multisampled, sampled (1 = sampled, 2 = storage)
+                            const std::uint32_t dim = t.operands.at(1);
+                            const bool storage = t.operands.at(5) == 2;
+                            if (dim == image_dim_subpass_data) {
+                                return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                            }
+                            if (dim == image_dim_buffer) {
+                                return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                            }
+                            return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                        }
+                        default:
+                            return std::nullopt;
+                    }
+                case storage_class::uniform:
+                    // Storage buffers were declared as BufferBlock uniforms before SPIR-V 1.3
+                    return module.decorations(resource_type).buffer_block ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                case storage_class::storage_buffer:
+                    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                default:
+                    return std::nullopt;
+            }
+        }
+    }
+
+    ShaderReflection::ShaderReflection(const std::span<const std::uint32_t> spirv) {
+        const Module module(spirv);
+        _requires_buffer_device_address = module.uses_device_addresses;
+
+        std::map<std::uint32_t, std::map<std::uint32_t, VkDescriptorSetLayoutBinding>> sets;
+        for (const auto& [id, variable] : module.variables) {
+            if (variable.stages == 0 || !is_reflected(variable.storage_class)) {
+                continue;  // Declared but not used by any entry point, or e.g. a Private or Output variable
+            }
+
+            const std::uint32_t type = module.pointee(variable.type);
+            const Decorations& decorations = module.decorations(id);
+
+            if (variable.storage_class == storage_class::push_constant) {
+                const std::uint32_t offset = module.first_offset(type);
+                _push_constant_ranges.push_back(VkPushConstantRange {
+                    .stageFlags = variable.stages,
+                    .offset     = offset,
+                    .size       = module.size_of(type) - offset
+                });
+                continue;
+            }
+
+            if (variable.storage_class == storage_class::input) {
+                if (decorations.built_in || !decorations.location.has_value() || !(variable.stages & VK_SHADER_STAGE_VERTEX_BIT)) {
+                    continue;
+                }
+
+                // Arrays and matrices take consecutive locations, one per element or column
+                std::uint32_t location = *decorations.location;
+                std::uint32_t element = type;
+                std::uint32_t repeat = 1;
+                if (module.type(element).opcode == op::type_array) {
+                    repeat = module.constant(module.type(element).operands.at(1));
+                    element = module.type(element).operands.at(0);
+                }
+                if (module.type(element).opcode == op::type_matrix) {
+                    repeat *= module.type(element).operands.at(1);
+                    element = module.type(element).operands.at(0);
+                }
+
+                const Type& element_type = module.type(element);
+                const bool is_vector = element_type.opcode == op::type_vector;
+                const VkFormat format = is_vector
+                    ? to_format(module.type(element_type.operands.at(0)), element_type.operands.at(1))
+                    : to_format(element_type, 1);
+
+                for (std::uint32_t i = 0; i < repeat; ++i) {
+                    _vertex_inputs.push_back(ReflectedVertexInput {
+                        .location = location++,
+                        .format   = format,
+                        .size     = module.size_of(element)
+                    });
+                }
+                continue;
+            }
+
+            // Arrays of resources become the descriptor count
+            std::uint32_t resource_type = type;
+            std::uint32_t count = 1;
+            for (const Type* t = &module.type(resource_type); t->opcode == op::type_array || t->opcode == op::type_runtime_array; t = &module.type(resource_type)) {
+                count = t->opcode == op::type_array ? count * module.constant(t->operands.at(1)) : 0;
+                resource_type = t->operands.at(0);
+            }
+
+            const auto descriptor_type = to_descriptor_type(module, variable, resource_type);
+            if (!descriptor_type.has_value() || !decorations.binding.has_value()) {
+                continue;
+            }
+
+            const std::uint32_t set = decorations.set.value_or(0);
+            auto [it, inserted] = sets[set].try_emplace(*decorations.binding, VkDescriptorSetLayoutBinding {
+                .binding         = *decorations.binding,
+                .descriptorType  = *descriptor_type,
+                .descriptorCount = count,
+                .stageFlags      = variable.stages
+            });
+
+            if (!inserted) {
+                // Aliased declarations of one binding, e.g. the same buffer viewed as different structs
+                if (it->second.descriptorType != *descriptor_type) {
+                    throw std::runtime_error("Set " + std::to_string(set) + " binding " + std::to_string(*decorations.binding) + " is declared with conflicting descriptor types.");
+                }
+                it->second.stageFlags |= variable.stages;
+            }
+        }
+
+        for (const auto& [set, bindings] : sets) {
+            ReflectedSet& reflected = _sets.emplace_back(ReflectedSet {.set = set});
+            for (const auto& [binding, layout_binding] : bindings) {
+                reflected.bindings.push_back(layout_binding);
+            }
+        }
+
+        std::ranges::sort(_vertex_inputs, {}, &ReflectedVertexInput::location);
+    }
+
+    const std::vector<ReflectedSet>& ShaderReflection::get_sets() const {
+        return _sets;
+    }
+
+    const std::vector<VkPushConstantRange>& ShaderReflection::get_push_constant_ranges() const {
+        return _push_constant_ranges;
+    }
+
+    const std::vector<ReflectedVertexInput>& ShaderReflection::get_vertex_inputs() const {
+        return _vertex_inputs;
+    }
+
+    bool ShaderReflection::requires_buffer_device_address() const {
+        return _requires_buffer_device_address;
+    }
+
+    std::vector<VkDescriptorSetLayout> ShaderReflection::create_set_layouts(DescriptorLayoutCache& cache) const {
+        if (_sets.empty()) {
+            return {};
+        }
+
+        std::vector<VkDescriptorSetLayout> layouts(_sets.back().set + 1, VK_NULL_HANDLE);
+        for (const auto& [set, bindings] : _sets) {
+            layouts[set] = cache.get(bindings);
+        }
+
+        // Pipeline layouts cannot have holes, unused set numbers get an empty layout
+        for (auto& layout : layouts) {
+            if (layout == VK_NULL_HANDLE) {
+                layout = cache.get({});
+            }
+        }
+
+        return layouts;
+    }
+
+    VertexInfo ShaderReflection::create_vertex_info(const std::vector<VertexBindingLayout>& bindings) const {
+        if (bindings.empty()) {
+            throw std::runtime_error("At least one vertex binding is required.");
+        }
+
+        std::vector<VertexBindingLayout> sorted = bindings;
+        std::ranges::sort(sorted, {}, &VertexBindingLayout::first_location);
+
+        VertexInfo vertex_info {};
+        for (std::size_t b = 0; b < sorted.size(); ++b) {
+            const std::uint32_t end = b + 1 < sorted.size() ? sorted[b + 1].first_location : UINT32_MAX;
+
+            std::uint32_t offset = 0;
+            for (const auto& input : _vertex_inputs) {
+                if (input.location < sorted[b].first_location || input.location >= end) {
+                    continue;
+                }
+
+                vertex_info.attribute_descriptions.push_back(VkVertexInputAttributeDescription {
+                    .location = input.location,
+                    .binding  = sorted[b].binding,
+                    .format   = input.format,
+                    .offset   = offset
+                });
+                offset += input.size;
+            }
+
+            vertex_info.add_binding_description(sorted[b].stride != 0 ? sorted[b].stride : offset, sorted[b].binding, sorted[b].input_rate);
+        }
+
+        vertex_info.generate_vertex_info();
+
+        return vertex_info;
+    }
+}  // namespace fr
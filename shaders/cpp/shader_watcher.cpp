@@ -0,0 +1,163 @@
+#include "shader_watcher.h"
+#include "utils/file_system.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include <poll.h>
+#include <spawn.h>
+#include <sys/inotify.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace fr {
+    namespace {
+        constexpr int poll_interval_ms = 100;
+        constexpr int settle_ms = 50;  // Editors often write a file in several steps
+        constexpr std::uint32_t spirv_magic = 0x07230203;
+    }
+
+    ShaderWatcher::ShaderWatcher(std::filesystem::path source_dir, std::filesystem::path slangc)
+        : _source_dir(std::move(source_dir))
+        , _slangc(std::move(slangc))
+        , _output_dir(std::filesystem::temp_directory_path() / "four_rendering" / "hot_reload")
+    {
+        std::filesystem::create_directories(_output_dir);
+
+        _inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_inotify_fd < 0) {
+            throw std::runtime_error("Failed to initialise inotify: " + std::string(std::strerror(errno)));
+        }
+
+        // Saving through a temporary file and renaming it shows up as IN_MOVED_TO rather than IN_CLOSE_WRITE
+        if (inotify_add_watch(_inotify_fd, _source_dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            close(_inotify_fd);
+            throw std::runtime_error("Failed to watch " + _source_dir.string() + ": " + std::strerror(errno));
+        }
+
+        _thread = std::thread(&ShaderWatcher::_watch_loop, this);
+    }
+
+    ShaderWatcher::~ShaderWatcher() {
+        _stopping = true;
+        _thread.join();
+
+        close(_inotify_fd);
+    }
+
+    std::vector<CompiledShader> ShaderWatcher::take_compiled() {
+        std::lock_guard lock(_mutex);
+        return std::exchange(_compiled, {});
+    }
+
+    void ShaderWatcher::_watch_loop() {
+        while (!_stopping) {
+            std::set<std::string> changes = _read_changes(poll_interval_ms);
+            if (changes.empty()) {
+                continue;
+            }
+
+            // Coalesce the burst of events a single save produces
+            for (auto more = _read_changes(settle_ms); !more.empty(); more = _read_changes(settle_ms)) {
+                changes.merge(more);
+            }
+
+            for (const auto& name : changes) {
+                try {
+                    _compile(name);
+                } catch (const std::exception& e) {
+                    std::cerr << "Failed to reload " << name << ": " << e.what() << "\n";
+                }
+            }
+        }
+    }
+
+    std::set<std::string> ShaderWatcher::_read_changes(const int timeout_ms) const {
+        pollfd poll_fd {
+            .fd     = _inotify_fd,
+            .events = POLLIN
+        };
+
+        std::set<std::string> changes;
+        if (poll(&poll_fd, 1, timeout_ms) <= 0) {
+            return changes;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(_inotify_fd, buffer, sizeof(buffer))) > 0) {
+            for (const char* cursor = buffer; cursor < buffer + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+                cursor += sizeof(inotify_event) + event->len;
+
+                if (event->len == 0) {
+                    continue;
+                }
+
+                const std::filesystem::path file_name = event->name;
+                if (file_name.extension() == ".slang") {
+                    changes.insert(file_name.stem().string());
+                }
+            }
+        }
+
+        return changes;
+    }
+
+    void ShaderWatcher::_compile(const std::string& name) {
+        const std::string source = (_source_dir / (name + ".slang")).string();
+        const std::string output = (_output_dir / (name + ".spv")).string();
+        const std::string slangc = _slangc.string();
+
+        // Spawned directly rather than through a shell, so paths need no quoting
+        std::vector<char*> arguments {
+            const_cast<char*>(slangc.c_str()),
+            const_cast<char*>(source.c_str()),
+            const_cast<char*>("-target"),
+            const_cast<char*>("spirv"),
+            const_cast<char*>("-o"),
+            const_cast<char*>(output.c_str()),
+            nullptr
+        };
+
+        pid_t pid;
+        if (const int error = posix_spawn(&pid, slangc.c_str(), nullptr, nullptr, arguments.data(), environ); error != 0) {
+            std::cerr << "Failed to run slangc for " << name << ": " << std::strerror(error) << "\n";
+            return;
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "Failed to compile " << name << ".slang, keeping the previous version.\n";
+            return;
+        }
+
+        const std::vector<char> bytes = file_system::read_binary_file(output);
+        if (bytes.size() < sizeof(std::uint32_t) || bytes.size() % sizeof(std::uint32_t) != 0) {
+            std::cerr << "slangc wrote an invalid SPIR-V binary for " << name << ".\n";
+            return;
+        }
+
+        CompiledShader compiled {
+            .name = name,
+            .code = std::vector<std::uint32_t>(bytes.size() / sizeof(std::uint32_t))
+        };
+        std::memcpy(compiled.code.data(), bytes.data(), bytes.size());
+
+        if (compiled.code.front() != spirv_magic) {
+            std::cerr << "slangc wrote an invalid SPIR-V binary for " << name << ".\n";
+            return;
+        }
+
+        // A newer compile of the same shader replaces one that has not been taken yet
+        std::lock_guard lock(_mutex);
+        std::erase_if(_compiled, [&name](const CompiledShader& shader) { return shader.name == name; });
+        _compiled.push_back(std::move(compiled));
+    }
+}  // namespace fr
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace fr {
+    struct EmbeddedShader {
+        std::string_view name;
+        std::span<const std::uint32_t> spirv;
+    };
+
+    /// SPIR-V compiled from shaders/slang/<name>.slang at build time. Throws when no such shader was embedded.
+    std::span<const std::uint32_t> embedded_spirv(std::string_view name);
+}  // namespace fr
@@ -1,5 +1,12 @@
 #pragma once
 
+#include "shader_reflection.h"
+#include "builders/vulkan_structures.h"
+#include "specialization_constants.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -8,29 +15,54 @@
 namespace fr {
     class Shader {
     public:
-        std::string shader_dir = "/opt/four_map_engine/four_rendering/shaders/spirv/";
-
+        /// Uses the SPIR-V embedded at build time from shaders/slang/<shader_name>.slang
         explicit Shader(std::string shader_name, const VkDevice& device);
 
+        /// Uses SPIR-V compiled elsewhere, e.g. at runtime
+        Shader(std::string shader_name, std::vector<std::uint32_t> code, const VkDevice& device);
+
         ~Shader();
 
-        void create_shader_program();
+        Shader(const Shader&) = delete;
+        Shader& operator=(const Shader&) = delete;
 
+        /// Throws when the SPIR-V needs a device feature that features does not enable, e.g. grid's tile table
+        ///     needs Features::buffer_device_address
+        void create_shader_program(const Features& features);
+
+        /// The stages point at this shader's specialization constants, so they are valid while it is alive
         [[nodiscard]] std::vector<VkPipelineShaderStageCreateInfo> get_shader_stages() const;
 
+        /// Applies to every stage, constant ids are shared by all entry points of the module
+        void set_specialization_constants(SpecializationConstants constants);
+
+        [[nodiscard]] const SpecializationConstants& get_specialization_constants() const;
+
+        /// The SPIR-V, e.g. for shader objects, which are created from code rather than modules
+        [[nodiscard]] std::span<const std::uint32_t> get_code() const;
+
+        /// Hash of the SPIR-V, identifies the program in pipeline keys (see PipelineDescription)
+        [[nodiscard]] std::uint64_t get_code_hash() const;
+
+        /// Descriptor, push constant and vertex input layouts declared by the SPIR-V, parsed once per shader
+        [[nodiscard]] const ShaderReflection& get_reflection();
+
         void destroy_shaders();
 
     private:
         std::string _shader_name;
         VkDevice _device;
-        VkShaderModule _vertex_shader_module {};
-        VkShaderModule _fragment_shader_module {};
+        std::vector<std::uint32_t> _owned_code;
+        std::span<const std::uint32_t> _code;
+        VkShaderModule _shader_module {};  // One module per file, holding every entry point
         std::vector<VkPipelineShaderStageCreateInfo> _shader_stages;
+        std::uint64_t _code_hash = 0;
+        std::optional<ShaderReflection> _reflection;
+        SpecializationConstants _specialization;
+        VkSpecializationInfo _specialization_info {};
 
-        void _read_shader_file();
-
-        VkShaderModule _create_shader_module(const std::vector<char>& code);
+        VkShaderModule _create_shader_module() const;
 
         static VkPipelineShaderStageCreateInfo _create_shader_stage_info(const VkShaderModule& module, VkShaderStageFlagBits stage, const char* pipeline_name);
     };
-}  // namespace fr
\ No newline at end of file
+}  // namespace fr
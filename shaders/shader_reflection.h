@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "drawing/vertex_info.h"
+
+namespace fr {
+    class DescriptorLayoutCache;
+
+    struct ReflectedSet {
+        std::uint32_t set;
+        std::vector<VkDescriptorSetLayoutBinding> bindings;  // Sorted by binding
+    };
+
+    struct ReflectedVertexInput {
+        std::uint32_t location;
+        VkFormat format;
+        std::uint32_t size;  // Bytes
+    };
+
+    /// Assigns the vertex inputs from first_location up to the next layout's first_location to a vertex buffer binding
+    struct VertexBindingLayout {
+        std::uint32_t binding = 0;
+        VkVertexInputRate input_rate = VK_VERTEX_INPUT_RATE_VERTEX;
+        std::uint32_t first_location = 0;
+        std::uint32_t stride = 0;  // 0 when the attributes are tightly packed
+    };
+
+    /*
+     *  Reads the resource interface of a SPIR-V module: descriptor bindings per set, push constant ranges and vertex
+     *      inputs, with stage flags taken from the entry points that use them.
+     *
+     *  Descriptor types are inferred from the declarations, so dynamic uniform/storage buffers come back as their
+     *      non-dynamic types. Runtime sized (bindless) arrays have a descriptorCount of 0 and must be sized by the caller.
+     */
+    class ShaderReflection {
+    public:
+        explicit ShaderReflection(std::span<const std::uint32_t> spirv);
+
+        [[nodiscard]] const std::vector<ReflectedSet>& get_sets() const;
+
+        [[nodiscard]] const std::vector<VkPushConstantRange>& get_push_constant_ranges() const;
+
+        /// Inputs of the vertex entry point, sorted by location. Matrices take one location per column.
+        [[nodiscard]] const std::vector<ReflectedVertexInput>& get_vertex_inputs() const;
+
+        /// The module declares PhysicalStorageBufferAddresses, i.e. reads buffers through device addresses
+        [[nodiscard]] bool requires_buffer_device_address() const;
+
+        /// One layout per set number up to the highest set used; unused set numbers get an empty layout. Layouts with
+        ///     the same signature are shared with every other user of the cache.
+        [[nodiscard]] std::vector<VkDescriptorSetLayout> create_set_layouts(DescriptorLayoutCache& cache) const;
+
+        /// Attributes laid out in location order within each binding
+        [[nodiscard]] VertexInfo create_vertex_info(const std::vector<VertexBindingLayout>& bindings = {VertexBindingLayout {}}) const;
+
+    private:
+        std::vector<ReflectedSet> _sets;
+        std::vector<VkPushConstantRange> _push_constant_ranges;
+        std::vector<ReflectedVertexInput> _vertex_inputs;
+        bool _requires_buffer_device_address = false;
+    };
+}  // namespace fr
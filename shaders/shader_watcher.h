@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fr {
+    struct CompiledShader {
+        std::string name;  // File stem, e.g. "grid" for grid.slang
+        std::vector<std::uint32_t> code;
+    };
+
+    /*
+     *  Development only: watches a directory of .slang sources with inotify and recompiles a file with slangc on a
+     *      background thread whenever it is written. Poll take_compiled() once per frame and rebuild the pipelines that
+     *      use the returned shaders (see Shader's SPIR-V constructor and PipelineRegistry).
+     *
+     *  A failed compile is reported on std::cerr and produces nothing, so the running shader stays in use.
+     *  Only the file that changed is recompiled; shaders importing it are not tracked.
+     */
+    class ShaderWatcher {
+    public:
+        ShaderWatcher(std::filesystem::path source_dir, std::filesystem::path slangc);
+
+        ~ShaderWatcher();
+
+        ShaderWatcher(const ShaderWatcher&) = delete;
+        ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+        /// Shaders recompiled since the last call, at most one per name
+        std::vector<CompiledShader> take_compiled();
+
+    private:
+        std::filesystem::path _source_dir;
+        std::filesystem::path _slangc;
+        std::filesystem::path _output_dir;
+        int _inotify_fd = -1;
+        std::atomic<bool> _stopping = false;
+        std::mutex _mutex;
+        std::vector<CompiledShader> _compiled;
+        std::thread _thread;
+
+        void _watch_loop();
+
+        /// Names of the .slang files written during the next poll interval, empty on timeout
+        std::set<std::string> _read_changes(int timeout_ms) const;
+
+        void _compile(const std::string& name);
+    };
+}  // namespace fr
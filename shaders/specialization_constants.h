@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace fr {
+    /// Values for a module's specialization constants (its [vk::constant_id(n)] declarations), packed for
+    ///     VkSpecializationInfo. Constants that are not set keep the default declared in the shader.
+    class SpecializationConstants {
+    public:
+        SpecializationConstants() = default;
+
+        /// Copies the entries and data info points at
+        explicit SpecializationConstants(const VkSpecializationInfo& info)
+            : _entries(info.pMapEntries, info.pMapEntries + info.mapEntryCount)
+            , _data(static_cast<const std::uint8_t*>(info.pData), static_cast<const std::uint8_t*>(info.pData) + info.dataSize)
+        { }
+
+        /// Booleans are stored as VkBool32, as the shader reads them
+        template<typename T>
+            requires std::is_arithmetic_v<T>
+        SpecializationConstants& set(const std::uint32_t constant_id, const T value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                return set(constant_id, static_cast<VkBool32>(value ? VK_TRUE : VK_FALSE));
+            } else {
+                for (const auto& entry : _entries) {
+                    if (entry.constantID == constant_id) {
+                        if (entry.size != sizeof(T)) {
+                            throw std::runtime_error("Specialization constant " + std::to_string(constant_id) + " was set with a different size.");
+                        }
+
+                        std::memcpy(_data.data() + entry.offset, &value, sizeof(T));
+                        return *this;
+                    }
+                }
+
+                _entries.push_back(VkSpecializationMapEntry {
+                    .constantID = constant_id,
+                    .offset     = static_cast<std::uint32_t>(_data.size()),
+                    .size       = sizeof(T)
+                });
+                _data.resize(_data.size() + sizeof(T));
+                std::memcpy(_data.data() + _entries.back().offset, &value, sizeof(T));
+
+                return *this;
+            }
+        }
+
+        [[nodiscard]] bool empty() const {
+            return _entries.empty();
+        }
+
+        [[nodiscard]] const std::vector<VkSpecializationMapEntry>& get_entries() const {
+            return _entries;
+        }
+
+        [[nodiscard]] const std::vector<std::uint8_t>& get_data() const {
+            return _data;
+        }
+
+        /// Points into this object: valid while it is alive and not modified
+        [[nodiscard]] VkSpecializationInfo get_info() const {
+            return VkSpecializationInfo {
+                .mapEntryCount = static_cast<std::uint32_t>(_entries.size()),
+                .pMapEntries   = _entries.data(),
+                .dataSize      = _data.size(),
+                .pData         = _data.data()
+            };
+        }
+
+    private:
+        std::vector<VkSpecializationMapEntry> _entries;
+        std::vector<std::uint8_t> _data;
+    };
+}  // namespace fr
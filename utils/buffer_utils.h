@@ -11,7 +11,23 @@ namespace fr {
 
         void create_staging_buffer(BufferCore& buffer, VkDeviceSize buffer_size);
 
+        /// Creates a storage buffer that shaders can read through its 64-bit device address (stored in buffer.address).
+        ///     Requires Features::buffer_device_address.
+        void create_addressable_buffer(BufferCore& buffer, VkDeviceSize buffer_size, VkBufferUsageFlags usage = 0);
+
+        /// Creates an indirection table of device addresses, letting shaders reach any number of buffers from one pointer.
+        ///     addresses must not be empty.
+        void create_address_table(BufferCore& table, const std::vector<VkDeviceAddress>& addresses);
+
+        [[nodiscard]] VkDeviceAddress get_device_address(const BufferCore& buffer) const;
+
+        /// Maps a host visible buffer so it can be written in place. Write sequentially and never read back.
+        [[nodiscard]] void* map_buffer(const BufferCore& buffer) const;
+
+        /// Flushes the whole buffer and unmaps it
+        void unmap_buffer(const BufferCore& buffer) const;
+
     private:
         std::shared_ptr<VkContext> _context;
     };
-}
\ No newline at end of file
+}
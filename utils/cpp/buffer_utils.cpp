@@ -2,6 +2,7 @@
 #include "error.h"
 
 #include <ranges>
+#include <stdexcept>
 
 namespace fr {
     BufferUtils::BufferUtils(const std::shared_ptr<VkContext>& context)
@@ -28,6 +29,10 @@ namespace fr {
                 vmaCreateBuffer(_context->allocator, &buffer_info, &alloc_info, &buffer.buffer, &buffer.allocation, nullptr),
                 "Failed to create VMA buffer"
             );
+
+            if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+                buffer.address = get_device_address(buffer);
+            }
         }
     }
 
@@ -54,4 +59,57 @@ namespace fr {
             );
         }
     }
+
+    void BufferUtils::create_addressable_buffer(BufferCore& buffer, const VkDeviceSize buffer_size, const VkBufferUsageFlags usage) {
+        if (!_context->features.buffer_device_address) {
+            throw std::runtime_error("Buffer device addresses are not supported by the device, bind the buffer through a descriptor instead.");
+        }
+
+        create_buffer(buffer, buffer_size, usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT);
+    }
+
+    void BufferUtils::create_address_table(BufferCore& table, const std::vector<VkDeviceAddress>& addresses) {
+        if (addresses.empty()) {
+            throw std::runtime_error("Unable to create an address table without any addresses.");
+        }
+
+        const VkDeviceSize table_size = sizeof(VkDeviceAddress) * addresses.size();
+
+        create_addressable_buffer(table, table_size);
+        table.count = static_cast<std::uint32_t>(addresses.size());
+
+        validate(
+            vmaCopyMemoryToAllocation(_context->allocator, addresses.data(), table.allocation, 0, table_size),
+            "Failed to copy device addresses to the address table."
+        );
+    }
+
+    VkDeviceAddress BufferUtils::get_device_address(const BufferCore& buffer) const {
+        VkBufferDeviceAddressInfo address_info {
+            .sType  = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = buffer.buffer
+        };
+
+        return vkGetBufferDeviceAddress(_context->device, &address_info);
+    }
+
+    void* BufferUtils::map_buffer(const BufferCore& buffer) const {
+        void* data = nullptr;
+        validate(
+            vmaMapMemory(_context->allocator, buffer.allocation, &data),
+            "Failed to map VMA buffer."
+        );
+
+        return data;
+    }
+
+    void BufferUtils::unmap_buffer(const BufferCore& buffer) const {
+        // Flushing is a no-op for host coherent memory
+        validate(
+            vmaFlushAllocation(_context->allocator, buffer.allocation, 0, VK_WHOLE_SIZE),
+            "Failed to flush VMA buffer."
+        );
+
+        vmaUnmapMemory(_context->allocator, buffer.allocation);
+    }
 }
@@ -1,6 +1,13 @@
 #include "file_system.h"
 
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
 
 namespace fr::file_system {
     std::vector<char> read_binary_file(const std::filesystem::path& filename) {
@@ -19,4 +26,64 @@ namespace fr::file_system {
 
         return buffer;
     }
-}  // namespace four::file_system
\ No newline at end of file
+
+    std::uint64_t hash_bytes(const void* data, const std::size_t size, std::uint64_t seed) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            seed ^= bytes[i];
+            seed *= 0x100000001b3ull;
+        }
+
+        return seed;
+    }
+
+    std::uint64_t hash_file(const std::filesystem::path& filename) {
+        std::ifstream file(filename, std::ios::binary);
+
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file!");
+        }
+
+        // Hash in chunks so large images are never fully resident
+        std::vector<char> chunk(1 << 16);
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            hash = hash_bytes(chunk.data(), static_cast<std::size_t>(file.gcount()), hash);
+        }
+
+        return hash;
+    }
+
+    void write_file_atomically(const std::filesystem::path& filename, const std::vector<std::span<const std::byte>>& parts) {
+        // mkstemp picks a name no other thread or process is using
+        std::string temporary_name = filename.string() + ".tmp.XXXXXX";
+        const int fd = mkstemp(temporary_name.data());
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create temporary file!");
+        }
+
+        bool written = true;
+        for (const auto& part : parts) {
+            std::size_t offset = 0;
+            while (written && offset < part.size()) {
+                const ssize_t count = write(fd, part.data() + offset, part.size() - offset);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                written = count > 0;
+                offset += written ? static_cast<std::size_t>(count) : 0;
+            }
+        }
+
+        // The data must reach the disk before the rename, or a crash could leave the final name on a truncated file
+        written = written && fsync(fd) == 0;
+        written = close(fd) == 0 && written;
+
+        if (!written || std::rename(temporary_name.c_str(), filename.c_str()) != 0) {
+            unlink(temporary_name.c_str());
+            throw std::runtime_error("Failed to write file!");
+        }
+    }
+}  // namespace four::file_system
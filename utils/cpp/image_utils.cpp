@@ -1,6 +1,120 @@
 #include "image_utils.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+// The SSSE3 expansion is compiled for every x86 build and selected at runtime, baseline x86-64 only guarantees SSE2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <tmmintrin.h>
+    #define FR_RUNTIME_SSSE3 1
+#endif
+
 namespace fr::image {
+    namespace {
+        float srgb_to_linear(const float encoded) {
+            return encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+        }
+
+        struct SrgbTables {
+            std::array<float, 256> to_linear;
+            std::array<float, 255> thresholds;  // Linear value halfway (in sRGB) between encodings i and i + 1
+        };
+
+        const SrgbTables& srgb_tables() {
+            static const SrgbTables tables = [] {
+                SrgbTables result {};
+                for (std::uint32_t i = 0; i < 256; ++i) {
+                    result.to_linear[i] = srgb_to_linear(static_cast<float>(i) / 255.0f);
+                }
+                for (std::uint32_t i = 0; i < 255; ++i) {
+                    result.thresholds[i] = srgb_to_linear((static_cast<float>(i) + 0.5f) / 255.0f);
+                }
+
+                return result;
+            }();
+
+            return tables;
+        }
+
+        /// Rounds to the nearest sRGB encoding, matching what the GPU writes to an _SRGB image
+        std::uint8_t linear_to_srgb8(const float linear, const SrgbTables& tables) {
+            return static_cast<std::uint8_t>(std::upper_bound(tables.thresholds.begin(), tables.thresholds.end(), linear) - tables.thresholds.begin());
+        }
+
+        /// Colour channels are averaged in linear space, as vkCmdBlitImage does for _SRGB formats; alpha is linear already
+        void downsample_srgba8(const std::uint8_t* src, const std::uint32_t width, const std::uint32_t height, std::uint8_t* dst) {
+            const SrgbTables& tables = srgb_tables();
+            const std::uint32_t dst_width  = std::max(width / 2, 1u);
+            const std::uint32_t dst_height = std::max(height / 2, 1u);
+
+            for (std::uint32_t y = 0; y < dst_height; ++y) {
+                const std::uint8_t* row0 = src + static_cast<std::size_t>(std::min(y * 2,     height - 1)) * width * 4;
+                const std::uint8_t* row1 = src + static_cast<std::size_t>(std::min(y * 2 + 1, height - 1)) * width * 4;
+                std::uint8_t* out = dst + static_cast<std::size_t>(y) * dst_width * 4;
+
+                for (std::uint32_t x = 0; x < dst_width; ++x) {
+                    const std::uint32_t x0 = std::min(x * 2,     width - 1) * 4;
+                    const std::uint32_t x1 = std::min(x * 2 + 1, width - 1) * 4;
+
+                    for (std::uint32_t c = 0; c < 3; ++c) {
+                        const float sum = tables.to_linear[row0[x0 + c]] + tables.to_linear[row0[x1 + c]] +
+                            tables.to_linear[row1[x0 + c]] + tables.to_linear[row1[x1 + c]];
+                        out[x * 4 + c] = linear_to_srgb8(sum * 0.25f, tables);
+                    }
+
+                    const std::uint32_t alpha = row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] + row1[x1 + 3];
+                    out[x * 4 + 3] = static_cast<std::uint8_t>((alpha + 2) / 4);
+                }
+            }
+        }
+
+        void expand_rgb_to_rgba8_scalar(const std::uint8_t* src, const std::size_t texel_count, std::uint8_t* dst) {
+            for (std::size_t i = 0; i < texel_count; ++i) {
+                dst[i * 4 + 0] = src[i * 3 + 0];
+                dst[i * 4 + 1] = src[i * 3 + 1];
+                dst[i * 4 + 2] = src[i * 3 + 2];
+                dst[i * 4 + 3] = 255;
+            }
+        }
+
+#if defined(FR_RUNTIME_SSSE3)
+        __attribute__((target("ssse3")))
+        void expand_rgb_to_rgba8_ssse3(const std::uint8_t* src, const std::size_t texel_count, std::uint8_t* dst) {
+            // Spread 4 RGB texels (12 bytes) over 16 and set the alpha bytes, the 0x80 lanes are zeroed by the shuffle
+            const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+            const __m128i alpha   = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+            std::size_t i = 0;
+
+            // Each load reads 16 bytes for 12 used, so stop while the last load would still be within the source
+            for (; i + 16 <= texel_count; i += 16) {
+                const std::uint8_t* in = src + i * 3;
+                __m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));        // texels  0..5
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16));   // texels  5..10
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32));   // texels 10..15
+
+                _mm_storeu_si128(out + 0, _mm_or_si128(_mm_shuffle_epi8(a, shuffle), alpha));
+                _mm_storeu_si128(out + 1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), shuffle), alpha));
+                _mm_storeu_si128(out + 2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), shuffle), alpha));
+                _mm_storeu_si128(out + 3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(c, 4), shuffle), alpha));
+            }
+
+            expand_rgb_to_rgba8_scalar(src + i * 3, texel_count - i, dst + i * 4);
+        }
+#endif
+    }  // namespace
+
     void transition_layout(
         VkCommandBuffer cmd,
         VkImage image,
@@ -10,7 +124,11 @@ namespace fr::image {
         VkAccessFlags2 src_access_mask,
         VkAccessFlags2 dst_access_mask,
         VkPipelineStageFlags2 src_stage,
-        VkPipelineStageFlags2 dst_stage
+        VkPipelineStageFlags2 dst_stage,
+        std::uint32_t base_mip_level,
+        std::uint32_t mip_level_count,
+        std::uint32_t base_array_layer,
+        std::uint32_t layer_count
     ) {
         VkImageMemoryBarrier2 image_barrier {
             .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
@@ -35,10 +153,10 @@ namespace fr::image {
             // Define the subresource range (which parts of the image are affected)
             .subresourceRange = {
                 .aspectMask     = image_flag_bits,        // Affects the color aspect of the image
-                .baseMipLevel   = 0,                                // Start at mip level 0
-                .levelCount     = 1,                                // Number of mip levels affected
-                .baseArrayLayer = 0,                                // Start at array layer 0
-                .layerCount     = 1                                 // Number of array layers affected
+                .baseMipLevel   = base_mip_level,                   // First mip level affected
+                .levelCount     = mip_level_count,                  // Number of mip levels affected
+                .baseArrayLayer = base_array_layer,                 // First array layer affected
+                .layerCount     = layer_count                       // Number of array layers affected
             }
         };
 
@@ -53,4 +171,233 @@ namespace fr::image {
         // Record the pipeline barrier into the command buffer
         vkCmdPipelineBarrier2(cmd, &dependency_info);
     }
+
+    void generate_mipmaps(
+        VkCommandBuffer cmd,
+        VkImage image,
+        const std::uint32_t width,
+        const std::uint32_t height,
+        const std::uint32_t mip_levels,
+        const std::uint32_t array_layer
+    ) {
+        auto mip_width  = static_cast<std::int32_t>(width);
+        auto mip_height = static_cast<std::int32_t>(height);
+
+        for (std::uint32_t mip = 1; mip < mip_levels; ++mip) {
+            // The previous level has been written; make it the blit source
+            transition_layout(
+                cmd,
+                image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_ACCESS_2_TRANSFER_READ_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                mip - 1,
+                1,
+                array_layer
+            );
+
+            const std::int32_t next_width  = std::max(mip_width / 2, 1);
+            const std::int32_t next_height = std::max(mip_height / 2, 1);
+
+            VkImageBlit2 blit {
+                .sType          = VK_STRUCTURE_TYPE_IMAGE_BLIT_2,
+                .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip - 1, array_layer, 1},
+                .srcOffsets     = {{0, 0, 0}, {mip_width, mip_height, 1}},
+                .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip, array_layer, 1},
+                .dstOffsets     = {{0, 0, 0}, {next_width, next_height, 1}}
+            };
+
+            VkBlitImageInfo2 blit_info {
+                .sType          = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2,
+                .srcImage       = image,
+                .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                .dstImage       = image,
+                .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .regionCount    = 1,
+                .pRegions       = &blit,
+                .filter         = VK_FILTER_LINEAR
+            };
+            vkCmdBlitImage2(cmd, &blit_info);
+
+            // The previous level is final
+            transition_layout(
+                cmd,
+                image,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                VK_ACCESS_2_TRANSFER_READ_BIT,
+                VK_ACCESS_2_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                mip - 1,
+                1,
+                array_layer
+            );
+
+            mip_width  = next_width;
+            mip_height = next_height;
+        }
+
+        // The smallest level was only ever a blit destination
+        transition_layout(
+            cmd,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_ACCESS_2_SHADER_READ_BIT,
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            mip_levels - 1,
+            1,
+            array_layer
+        );
+    }
+
+    bool supports_linear_blit(VkPhysicalDevice gpu, const VkFormat format) {
+        VkFormatProperties format_properties;
+        vkGetPhysicalDeviceFormatProperties(gpu, format, &format_properties);
+
+        // Linear filtering is needed to downsample with vkCmdBlitImage2 using VK_FILTER_LINEAR
+        constexpr VkFormatFeatureFlags required_features =
+            VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+            VK_FORMAT_FEATURE_BLIT_DST_BIT |
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+        return (format_properties.optimalTilingFeatures & required_features) == required_features;
+    }
+
+    std::uint32_t calculate_mip_levels(const std::uint32_t width, const std::uint32_t height) {
+        return std::bit_width(std::max(std::max(width, height), 1u));
+    }
+
+    VkDeviceSize calculate_mip_chain_size(std::uint32_t width, std::uint32_t height, const std::uint32_t mip_levels, const std::uint32_t texel_size) {
+        VkDeviceSize size = 0;
+        for (std::uint32_t level = 0; level < mip_levels; ++level) {
+            size += static_cast<VkDeviceSize>(width) * height * texel_size;
+            width  = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+
+        return size;
+    }
+
+    void downsample_rgba8(const std::uint8_t* src, const std::uint32_t width, const std::uint32_t height, std::uint8_t* dst, const VkFormat format) {
+        if (format == VK_FORMAT_R8G8B8A8_SRGB) {
+            downsample_srgba8(src, width, height, dst);
+            return;
+        }
+
+        const std::uint32_t dst_width  = std::max(width / 2, 1u);
+        const std::uint32_t dst_height = std::max(height / 2, 1u);
+
+        for (std::uint32_t y = 0; y < dst_height; ++y) {
+            // Clamp to the last row/column so 1-texel wide levels average with themselves
+            const std::uint8_t* row0 = src + static_cast<std::size_t>(std::min(y * 2,     height - 1)) * width * 4;
+            const std::uint8_t* row1 = src + static_cast<std::size_t>(std::min(y * 2 + 1, height - 1)) * width * 4;
+            std::uint8_t* out = dst + static_cast<std::size_t>(y) * dst_width * 4;
+
+            std::uint32_t x = 0;
+
+#if defined(__SSE2__)
+            // Two output texels per iteration: widen to 16-bit, sum the 2x2 block, round and narrow
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i two  = _mm_set1_epi16(2);
+            for (; x * 2 + 4 <= width; x += 2) {
+                const __m128i top    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                const __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+                const __m128i sum_lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+                const __m128i sum_hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+                const __m128i texel0 = _mm_add_epi16(sum_lo, _mm_srli_si128(sum_lo, 8));
+                const __m128i texel1 = _mm_add_epi16(sum_hi, _mm_srli_si128(sum_hi, 8));
+
+                __m128i average = _mm_unpacklo_epi64(texel0, texel1);
+                average = _mm_srli_epi16(_mm_add_epi16(average, two), 2);
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(average, zero));
+            }
+#endif
+
+            for (; x < dst_width; ++x) {
+                const std::uint32_t x0 = std::min(x * 2,     width - 1) * 4;
+                const std::uint32_t x1 = std::min(x * 2 + 1, width - 1) * 4;
+
+                for (std::uint32_t c = 0; c < 4; ++c) {
+                    const std::uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                    out[x * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    void expand_to_rgba8(const std::uint8_t* src, const std::uint32_t channels, const std::size_t texel_count, std::uint8_t* dst) {
+        switch (channels) {
+            case 4:
+                std::memcpy(dst, src, texel_count * 4);
+                return;
+            case 3:
+#if defined(FR_RUNTIME_SSSE3)
+                if (__builtin_cpu_supports("ssse3")) {
+                    expand_rgb_to_rgba8_ssse3(src, texel_count, dst);
+                    return;
+                }
+#endif
+                expand_rgb_to_rgba8_scalar(src, texel_count, dst);
+                return;
+            case 2:
+                for (std::size_t i = 0; i < texel_count; ++i) {
+                    dst[i * 4 + 0] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i * 2];
+                    dst[i * 4 + 3] = src[i * 2 + 1];
+                }
+                return;
+            case 1:
+                for (std::size_t i = 0; i < texel_count; ++i) {
+                    dst[i * 4 + 0] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i];
+                    dst[i * 4 + 3] = 255;
+                }
+                return;
+            default:
+                throw std::runtime_error("Unsupported number of image channels.");
+        }
+    }
+
+    std::vector<std::span<const std::uint8_t>> generate_mip_chain_rgba8(
+        const std::uint8_t* base,
+        std::uint32_t width,
+        std::uint32_t height,
+        const std::uint32_t mip_levels,
+        const VkFormat format,
+        std::vector<std::uint8_t>& chain
+    ) {
+        const std::size_t base_size = static_cast<std::size_t>(width) * height * 4;
+        chain.resize(calculate_mip_chain_size(width, height, mip_levels, 4) - base_size);
+
+        std::vector<std::span<const std::uint8_t>> levels = {
+            std::span(base, base_size)
+        };
+
+        std::size_t offset = 0;
+        for (std::uint32_t mip = 1; mip < mip_levels; ++mip) {
+            const std::uint32_t next_width  = std::max(width / 2, 1u);
+            const std::uint32_t next_height = std::max(height / 2, 1u);
+            const std::size_t next_size = static_cast<std::size_t>(next_width) * next_height * 4;
+
+            downsample_rgba8(levels.back().data(), width, height, chain.data() + offset, format);
+            levels.emplace_back(chain.data() + offset, next_size);
+
+            offset += next_size;
+            width  = next_width;
+            height = next_height;
+        }
+
+        return levels;
+    }
 }  // namespace fr
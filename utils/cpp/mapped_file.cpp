@@ -0,0 +1,75 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fr::file_system {
+    MappedFile::MappedFile(const std::filesystem::path& filename) {
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file for mapping!");
+        }
+
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0) {
+            close(fd);
+            throw std::runtime_error("Failed to stat mapped file!");
+        }
+
+        _size = static_cast<std::size_t>(file_stat.st_size);
+        if (_size > 0) {
+            _data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);  // the mapping keeps its own reference to the file
+
+        if (_data == MAP_FAILED) {
+            _data = nullptr;
+            throw std::runtime_error("Failed to map file!");
+        }
+
+        // The contents are read once front to back when copied into staging memory
+        if (_data != nullptr) {
+            madvise(_data, _size, MADV_SEQUENTIAL);
+        }
+    }
+
+    MappedFile::~MappedFile() {
+        _unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _data(std::exchange(other._data, nullptr))
+        , _size(std::exchange(other._size, 0))
+    { }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            _unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+
+        return *this;
+    }
+
+    const std::byte* MappedFile::data() const {
+        return static_cast<const std::byte*>(_data);
+    }
+
+    std::size_t MappedFile::size() const {
+        return _size;
+    }
+
+    void MappedFile::_unmap() {
+        if (_data != nullptr) {
+            munmap(_data, _size);
+            _data = nullptr;
+            _size = 0;
+        }
+    }
+}  // namespace fr::file_system
@@ -0,0 +1,52 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace fr {
+    ThreadPool::ThreadPool(const std::size_t n_threads) {
+        // hardware_concurrency() may report 0 when it cannot be determined
+        const std::size_t count = std::max<std::size_t>(n_threads, 1);
+
+        _workers.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            _workers.emplace_back(&ThreadPool::_worker_loop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+
+        // Workers drain the remaining tasks before exiting
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::size() const {
+        return _workers.size();
+    }
+
+    void ThreadPool::_worker_loop() {
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock lock(_mutex);
+                _condition.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+
+                if (_tasks.empty()) {
+                    return;  // stopping and nothing left to run
+                }
+
+                task = std::move(_tasks.front());
+                _tasks.pop();
+            }
+
+            task();
+        }
+    }
+}  // namespace fr
@@ -1,8 +1,21 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <filesystem>
 
 namespace fr::file_system {
     std::vector<char> read_binary_file(const std::filesystem::path& filename);
-}  // namespace four::file_system
\ No newline at end of file
+
+    /// 64-bit FNV-1a hash of a byte range
+    std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed = 0xcbf29ce484222325ull);
+
+    /// 64-bit FNV-1a hash of a file's contents
+    std::uint64_t hash_file(const std::filesystem::path& filename);
+
+    /// Writes parts back to back to a uniquely named temporary file next to filename, syncs it to disk and renames it
+    ///     over filename, so readers in any process see either the old file or the complete new one.
+    void write_file_atomically(const std::filesystem::path& filename, const std::vector<std::span<const std::byte>>& parts);
+}  // namespace four::file_system
@@ -23,6 +23,9 @@ namespace fr {
             "VK_LAYER_KHRONOS_validation"
         };
 
+        /// Enabled when installed, provides VK_EXT_shader_object where the driver does not
+        inline constexpr const char* shader_object_layer = "VK_LAYER_KHRONOS_shader_object";
+
         const std::vector<const char*> device_extensions = {
             VK_KHR_SWAPCHAIN_EXTENSION_NAME,
             "VK_EXT_extended_dynamic_state3",
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
+#include <vector>
+
 #include <vulkan/vulkan.h>
 
 namespace fr::image {
@@ -12,6 +16,50 @@ namespace fr::image {
         VkAccessFlags2        src_access_mask,
         VkAccessFlags2        dst_access_mask,
         VkPipelineStageFlags2 src_stage,
-        VkPipelineStageFlags2 dst_stage
+        VkPipelineStageFlags2 dst_stage,
+        std::uint32_t         base_mip_level = 0,
+        std::uint32_t         mip_level_count = 1,
+        std::uint32_t         base_array_layer = 0,
+        std::uint32_t         layer_count = 1
+    );
+
+    /*
+     *  Builds levels 1..mip_levels-1 of one array layer with a vkCmdBlitImage2 chain.
+     *  Expects every level of the layer in TRANSFER_DST_OPTIMAL with level 0 written, leaves them in SHADER_READ_ONLY_OPTIMAL.
+     */
+    void generate_mipmaps(
+        VkCommandBuffer cmd,
+        VkImage         image,
+        std::uint32_t   width,
+        std::uint32_t   height,
+        std::uint32_t   mip_levels,
+        std::uint32_t   array_layer = 0
+    );
+
+    /// True when the format can be downsampled on the GPU with vkCmdBlitImage2 and VK_FILTER_LINEAR
+    bool supports_linear_blit(VkPhysicalDevice gpu, VkFormat format);
+
+    /// Number of mip levels in a full chain down to 1x1
+    std::uint32_t calculate_mip_levels(std::uint32_t width, std::uint32_t height);
+
+    /// Total size in bytes of a full mip chain for an uncompressed format
+    VkDeviceSize calculate_mip_chain_size(std::uint32_t width, std::uint32_t height, std::uint32_t mip_levels, std::uint32_t texel_size);
+
+    /// Halves an RGBA8 image with a 2x2 box filter. dst must hold max(1, width / 2) * max(1, height / 2) texels.
+    /// VK_FORMAT_R8G8B8A8_SRGB texels are filtered in linear space like a GPU blit, other formats as stored.
+    void downsample_rgba8(const std::uint8_t* src, std::uint32_t width, std::uint32_t height, std::uint8_t* dst, VkFormat format);
+
+    /// Expands 1 (grey), 2 (grey, alpha), 3 (RGB) or 4 channel texels to RGBA8, matching stb_image's conversion.
+    /// dst may be mapped, write-combined memory: it is written once, sequentially, and never read.
+    void expand_to_rgba8(const std::uint8_t* src, std::uint32_t channels, std::size_t texel_count, std::uint8_t* dst);
+
+    /// Filters levels 1..mip_levels-1 of an RGBA8 image into chain, packed back to back. Returns a view of every level, base included.
+    std::vector<std::span<const std::uint8_t>> generate_mip_chain_rgba8(
+        const std::uint8_t*        base,
+        std::uint32_t              width,
+        std::uint32_t              height,
+        std::uint32_t              mip_levels,
+        VkFormat                   format,
+        std::vector<std::uint8_t>& chain
     );
-}  // namespace fr
\ No newline at end of file
+}  // namespace fr
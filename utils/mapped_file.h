@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace fr::file_system {
+    /// Read-only memory mapping of a whole file, unmapped when it falls out of scope
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path& filename);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        [[nodiscard]] const std::byte* data() const;
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        void* _data = nullptr;
+        std::size_t _size = 0;
+
+        void _unmap();
+    };
+}  // namespace fr::file_system
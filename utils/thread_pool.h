@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fr {
+    /// A fixed set of worker threads consuming a FIFO task queue
+    class ThreadPool {
+    public:
+        explicit ThreadPool(std::size_t n_threads = std::thread::hardware_concurrency());
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Queues a task, the returned future holds its result (or rethrows its exception)
+        template<typename F>
+        auto submit(F&& task) -> std::future<std::invoke_result_t<F>> {
+            using Result = std::invoke_result_t<F>;
+
+            auto packaged_task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            std::future<Result> result = packaged_task->get_future();
+
+            {
+                std::lock_guard lock(_mutex);
+                _tasks.emplace([packaged_task] { (*packaged_task)(); });
+            }
+            _condition.notify_one();
+
+            return result;
+        }
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        std::vector<std::thread> _workers;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stopping = false;
+
+        void _worker_loop();
+    };
+}  // namespace fr